@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>     // Pour open
+#include <sys/mman.h>  // Pour mmap
+#include <sys/stat.h>
+#include <unistd.h>
+#include "assets.h"
+
+// Lire tout le fichier dès la projection quand le système le permet (Linux)
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+static const char ATLAS_MAGIC[8] = {'Q', 'N', 'R', 'B', 'A', 'T', 'L', '1'};
+
+static void write_u32(uint8_t* out, uint32_t value) {
+    for (int b = 0; b < 4; b++) {
+        out[b] = static_cast<uint8_t>(value >> (8 * b));
+    }
+}
+
+static uint32_t read_u32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+bool write_atlas(const char* filename, uint32_t width, uint32_t height,
+                 const AtlasRect sprites[ATLAS_SPRITES], const uint8_t* pixels) {
+    uint8_t header[ATLAS_HEADER_SIZE];
+    memcpy(header, ATLAS_MAGIC, sizeof(ATLAS_MAGIC));
+    write_u32(header + 8, ATLAS_VERSION);
+    write_u32(header + 12, width);
+    write_u32(header + 16, height);
+    write_u32(header + 20, ATLAS_SPRITES);
+    for (int i = 0; i < ATLAS_SPRITES; i++) {
+        uint8_t* rect = header + 24 + 16 * i;
+        write_u32(rect, sprites[i].x);
+        write_u32(rect + 4, sprites[i].y);
+        write_u32(rect + 8, sprites[i].width);
+        write_u32(rect + 12, sprites[i].height);
+    }
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(pixels, 1, bytes, file) == bytes;
+    return fclose(file) == 0 && ok;
+}
+
+bool AtlasFile::open(const char* filename) {
+    close();
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < ATLAS_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(mapping);
+    uint32_t width = read_u32(bytes + 12), height = read_u32(bytes + 16);
+    bool valid = memcmp(bytes, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) == 0 && read_u32(bytes + 8) == ATLAS_VERSION
+              && read_u32(bytes + 20) == ATLAS_SPRITES
+              && size == ATLAS_HEADER_SIZE + static_cast<size_t>(width) * height * 4;
+    for (int i = 0; valid && i < ATLAS_SPRITES; i++) {
+        const uint8_t* rect = bytes + 24 + 16 * i;
+        sprites[i] = {read_u32(rect), read_u32(rect + 4), read_u32(rect + 8), read_u32(rect + 12)};
+        valid = sprites[i].x + sprites[i].width <= width && sprites[i].y + sprites[i].height <= height;
+    }
+    if (!valid) {
+        munmap(mapping, size);
+        return false;
+    }
+    data = bytes;
+    length = size;
+    atlasWidth = width;
+    atlasHeight = height;
+    return true;
+}
+
+void AtlasFile::close() {
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = 0;
+    }
+}
+
+std::string executable_directory(const char* argv0) {
+    std::string path;
+    char buffer[4096];
+    ssize_t n = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1); // Linux
+    if (n > 0) {
+        path.assign(buffer, static_cast<size_t>(n));
+    } else if (argv0 != nullptr) {
+        path = argv0; // Ailleurs : le chemin par lequel on a été lancé
+    }
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string("./") : path.substr(0, slash + 1);
+}
@@ -0,0 +1,59 @@
+#ifndef CHESS_ASSETS_H
+#define CHESS_ASSETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Atlas des images de l'interface, préparé à la construction par chess_pack_assets :
+// le plateau et les huit pièces déjà décodés et mis à l'échelle dans une seule image
+// RGBA. Au démarrage il suffit de projeter le fichier en mémoire et d'envoyer les
+// pixels à la carte graphique en une fois, sans décoder aucun PNG.
+//
+// En-tête de 24 octets (magic "QNRBATL1", version u32, largeur u32, hauteur u32,
+// nombre d'images u32), puis un rectangle par image (x, y, largeur, hauteur en u32
+// petit-boutiste), puis les pixels RGBA ligne par ligne.
+
+#define ATLAS_VERSION 1
+#define ATLAS_SPRITES 9      // Le plateau, puis les pièces rangées par joueur puis par type
+#define ATLAS_BOARD 0
+#define ATLAS_CELL_SIZE 100  // Côté d'une case, en pixels, auquel les pièces sont réduites
+#define ATLAS_HEADER_SIZE (24 + ATLAS_SPRITES * 16)
+#define ATLAS_FILE_NAME "chess_assets.atlas"
+
+struct AtlasRect {
+    uint32_t x, y, width, height;
+};
+
+// Indice de la pièce dans l'atlas (type de 1 à 4)
+inline int atlas_piece(int player, int type) { return 1 + player * 4 + (type - 1); }
+
+// Écrire un atlas ; pixels contient width * height pixels RGBA
+bool write_atlas(const char* filename, uint32_t width, uint32_t height,
+                 const AtlasRect sprites[ATLAS_SPRITES], const uint8_t* pixels);
+
+// Atlas projeté en lecture seule
+class AtlasFile {
+public:
+    ~AtlasFile() { close(); }
+
+    bool open(const char* filename);
+    void close();
+
+    uint32_t width() const { return atlasWidth; }
+    uint32_t height() const { return atlasHeight; }
+    const AtlasRect& sprite(int index) const { return sprites[index]; }
+    const uint8_t* pixels() const { return data + ATLAS_HEADER_SIZE; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    uint32_t atlasWidth = 0, atlasHeight = 0;
+    AtlasRect sprites[ATLAS_SPRITES] = {};
+};
+
+// Dossier de l'exécutable (avec le séparateur final), pour trouver l'atlas à côté de
+// lui quel que soit le dossier courant
+std::string executable_directory(const char* argv0);
+
+#endif
@@ -0,0 +1,513 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "engine/attacks.h"
+#include "engine/movegen.h"
+#include "engine/mcts.h"
+#include "engine/nnue.h"
+#include "engine/search.h"
+#include "engine/tablebase.h"
+#include "engine/tt.h"
+
+// Banc d'essai sans interface graphique : perft contre des valeurs de référence,
+// recherche à profondeur fixe avec une signature (somme des noeuds), puis perft des
+// plateaux 8x8, 10x10 et 12x12 de position.h contre une référence mailbox. Le mode
+// mcts, à part car chronométré, mesure les simulations par seconde de mcts.h selon
+// le nombre de threads. Le mode nnue vérifie que les noyaux de nnue.h donnent tous
+// le même score, en évaluation complète comme incrémentale, puis mesure les
+// évaluations par seconde de chacun, seules et dans la recherche. Le mode tables
+// compare des positions tirées au hasard dans chaque table de finales à un solveur
+// exhaustif à profondeur bornée, écrit sans rien partager avec chess_tbgen.
+// Usage : chess_bench [perft|search|sizes|all] [profondeur]
+//         chess_bench mcts [temps par mesure en ms]
+//         chess_bench nnue [réseau]
+//         chess_bench tables [dossier] [profondeur du solveur]
+
+// Position enregistrée et nombre de feuilles attendu à chaque profondeur
+struct PerftCase {
+    const char* text;
+    uint64_t nodes[6]; // nodes[d - 1] = perft(d)
+};
+
+static const PerftCase PerftCases[] = {
+    {"RNBQ4/8/8/8/8/8/8/4qbnr 1", {35, 1204, 44363, 1609963, 60726500, 0}},
+    {"2B5/3N1Q2/8/6n1/8/3b2q1/8/R6r 1", {41, 1828, 72484, 3182639, 124903061, 0}},
+    {"1N3Q1r/8/8/6q1/8/3B4/R3n3/8 2", {38, 1606, 57992, 2420903, 87107218, 0}},
+    {"8/2Q5/N7/5R2/2B5/7q/8/1r6 2", {32, 1448, 45454, 2004025, 62351093, 0}},
+    {"4b3/3N4/8/8/2B3R1/2q2Q2/8/6n1 1", {49, 1326, 60775, 1683978, 74118717, 0}},
+    {"8/8/3Q4/8/8/4r3/8/8 1", {25, 340, 7512, 100550, 2209667, 29567231}},
+};
+
+#define PERFT_DEFAULT_DEPTH 4
+#define SEARCH_DEFAULT_DEPTH 9
+#define SIZES_DEFAULT_DEPTH 4
+#define MCTS_DEFAULT_MOVETIME 1000
+#define NNUE_GAMES 200        // Parties au hasard dont les positions servent aux mesures
+#define NNUE_GAME_PLIES 60
+#define NNUE_SEARCH_DEPTH 7
+#define TB_CHECK_DEPTH 6      // Distances vérifiées par le solveur, en demi-coups
+#define TB_CHECK_SAMPLES 200  // Positions tirées dans chaque table
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Compter les feuilles de l'arbre des coups à la profondeur donnée
+template <int N>
+static uint64_t perft(BasicPosition<N>& pos, BasicUndoStack<N>& stack, int depth) {
+    BasicMoveList<N> moves;
+    generate_moves(pos, moves);
+    if (depth == 1) {
+        return moves.size;
+    }
+    uint64_t nodes = 0;
+    for (auto m : moves) {
+        do_move(pos, m, stack);
+        nodes += perft(pos, stack, depth - 1);
+        undo_move(pos, stack);
+    }
+    return nodes;
+}
+
+// Retourne false si un compte diffère de la référence
+static bool run_perft(int depth) {
+    bool ok = true;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    std::cout << "perft" << std::endl;
+    for (const PerftCase& c : PerftCases) {
+        int d = depth;
+        while (d > 1 && c.nodes[d - 1] == 0) {
+            d--; // Pas de référence à cette profondeur pour cette position
+        }
+        Position pos;
+        UndoStack stack;
+        position_from_text(&pos, c.text);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(pos, stack, d);
+        double seconds = seconds_since(start);
+        bool match = nodes == c.nodes[d - 1];
+        ok = ok && match;
+        totalNodes += nodes;
+        totalSeconds += seconds;
+        std::cout << "  " << std::left << std::setw(36) << c.text << std::right
+                  << " profondeur " << d << " : " << std::setw(10) << nodes
+                  << (match ? "  ok  " : "  ERREUR (attendu " + std::to_string(c.nodes[d - 1]) + ")  ")
+                  << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " noeuds/s" << std::endl;
+    }
+    std::cout << "  total " << totalNodes << " noeuds, "
+              << static_cast<uint64_t>(totalSeconds > 0 ? totalNodes / totalSeconds : 0) << " noeuds/s" << std::endl;
+    return ok;
+}
+
+// Perft de référence sur la seule mailbox : double boucle sur les cases et marche
+// case par case le long de chaque direction, comme le faisait le premier code du jeu.
+// Lent, mais indépendant des bitboards qu'il sert à vérifier.
+template <int N>
+static uint64_t reference_perft(uint8_t squares[], Player side, int depth) {
+    static const int steps[PIECE_TYPE_COUNT][8][2] = {
+        {},
+        {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}},
+        {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}},
+        {{1, 0}, {-1, 0}, {0, 1}, {0, -1}},
+        {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}},
+    };
+    static const int stepCount[PIECE_TYPE_COUNT] = {0, 8, 8, 4, 4};
+    if (depth == 0) {
+        return 1;
+    }
+    uint64_t nodes = 0;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            uint8_t code = squares[y * N + x];
+            if (code == 0 || code_player(code) != side) {
+                continue;
+            }
+            PieceType type = code_type(code);
+            for (int d = 0; d < stepCount[type]; d++) {
+                int tx = x + steps[type][d][0], ty = y + steps[type][d][1];
+                while (tx >= 0 && tx < N && ty >= 0 && ty < N) {
+                    uint8_t target = squares[ty * N + tx];
+                    if (target != 0 && code_player(target) == side) {
+                        break;
+                    }
+                    squares[ty * N + tx] = code;
+                    squares[y * N + x] = 0;
+                    nodes += reference_perft<N>(squares, side == PLAYER1 ? PLAYER2 : PLAYER1, depth - 1);
+                    squares[y * N + x] = code;
+                    squares[ty * N + tx] = target;
+                    if (target != 0 || type == KNIGHT) {
+                        break;
+                    }
+                    tx += steps[type][d][0];
+                    ty += steps[type][d][1];
+                }
+            }
+        }
+    }
+    return nodes;
+}
+
+// Perft d'un plateau N x N depuis la position de départ, avec le générateur du moteur
+// instancié pour N, contre la référence mailbox
+template <int N>
+static bool run_size(int depth) {
+    BasicPosition<N> pos;
+    BasicUndoStack<N> stack;
+    initialize_board(&pos);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = perft(pos, stack, depth);
+    double seconds = seconds_since(start);
+
+    uint8_t squares[N * N];
+    std::copy(pos.squares, pos.squares + N * N, squares);
+    start = std::chrono::steady_clock::now();
+    uint64_t expected = reference_perft<N>(squares, PLAYER1, depth);
+    double referenceSeconds = seconds_since(start);
+
+    bool match = nodes == expected;
+    std::cout << "  " << std::setw(2) << N << "x" << std::left << std::setw(2) << N << std::right
+              << " (bitboard " << std::setw(3) << 8 * sizeof(BoardBitboard<N>) << " bits)"
+              << " profondeur " << depth << " : " << std::setw(10) << nodes
+              << (match ? "  ok  " : "  ERREUR (référence " + std::to_string(expected) + ")  ")
+              << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " noeuds/s, référence "
+              << static_cast<uint64_t>(referenceSeconds > 0 ? expected / referenceSeconds : 0) << " noeuds/s" << std::endl;
+    return match;
+}
+
+static bool run_sizes(int depth) {
+    std::cout << "tailles" << std::endl;
+    bool ok = run_size<BOARD_SIZE>(depth);
+    ok = run_size<10>(depth) && ok;
+    ok = run_size<12>(depth) && ok;
+    return ok;
+}
+
+// Recherche à profondeur fixe sur un seul thread, table vidée avant chaque position :
+// la signature ne change que si le comportement de la recherche change
+static void run_search(int depth) {
+    uint64_t signature = 0;
+    double totalSeconds = 0;
+    std::cout << "recherche" << std::endl;
+    for (const PerftCase& c : PerftCases) {
+        Position pos;
+        position_from_text(&pos, c.text);
+        TT.clear();
+        SearchLimits limits;
+        limits.depth = depth;
+        SearchResult result = search(pos, limits);
+        signature += result.nodes;
+        totalSeconds += result.seconds;
+        std::cout << "  " << std::left << std::setw(36) << c.text << std::right
+                  << " " << move_to_text(result.bestMove) << " score " << std::setw(6) << result.score
+                  << std::setw(12) << result.nodes << " noeuds, " << static_cast<uint64_t>(result.nps) << " noeuds/s"
+                  << ", branchement " << std::setprecision(3) << result.branching << std::endl;
+    }
+    std::cout << "  signature " << signature << ", "
+              << static_cast<uint64_t>(totalSeconds > 0 ? signature / totalSeconds : 0) << " noeuds/s" << std::endl;
+}
+
+// Simulations par seconde depuis la position de départ, de 1 thread à tous les coeurs
+static void run_mcts(int movetime) {
+    std::cout << "mcts" << std::endl;
+    Position pos;
+    initialize_board(&pos);
+    int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    double single = 0;
+    for (int threads = 1;; threads = std::min(threads * 2, cores)) {
+        SearchLimits limits;
+        limits.engine = ENGINE_MCTS;
+        limits.movetime = movetime;
+        limits.threads = threads;
+        SearchResult result = search(pos, limits);
+        double rate = result.seconds > 0 ? result.playouts / result.seconds : 0;
+        if (threads == 1) {
+            single = rate;
+        }
+        std::cout << "  " << std::setw(3) << threads << " threads : " << move_to_text(result.bestMove)
+                  << " score " << std::setw(5) << result.score << std::setw(10) << result.playouts << " simulations, "
+                  << static_cast<uint64_t>(rate) << " simulations/s (x" << std::setprecision(3)
+                  << (single > 0 ? rate / single : 0) << "), " << static_cast<uint64_t>(result.nps)
+                  << " positions/s, profondeur " << result.depth << std::endl;
+        if (threads == cores) {
+            break;
+        }
+    }
+}
+
+// Parties au hasard depuis les positions de référence : les coups joués, et chaque
+// position rencontrée
+static void random_games(std::vector<std::vector<Move>>& games, std::vector<Position>& positions) {
+    Prng rng(91);
+    for (int g = 0; g < NNUE_GAMES; g++) {
+        Position pos;
+        position_from_text(&pos, PerftCases[g % (sizeof(PerftCases) / sizeof(PerftCases[0]))].text);
+        games.emplace_back();
+        for (int ply = 0; ply < NNUE_GAME_PLIES && pos.counts[pos.sideToMove][EMPTY] > 0; ply++) {
+            MoveList moves;
+            generate_moves(pos, moves);
+            if (moves.size == 0) {
+                break;
+            }
+            Move m = moves.moves[rng.next() % moves.size];
+            games.back().push_back(m);
+            apply_move(pos, m);
+            positions.push_back(pos);
+        }
+    }
+}
+
+// Rejouer les parties en tenant les accumulateurs à jour coup par coup ; rend le
+// nombre d'évaluations, et faux dans mismatch si l'une diffère de l'évaluation complète
+static uint64_t replay_incremental(const std::vector<std::vector<Move>>& games, int64_t& checksum, bool check, bool& mismatch) {
+    std::unique_ptr<NnueStack> nnue(new NnueStack());
+    uint64_t evals = 0;
+    for (size_t g = 0; g < games.size(); g++) {
+        Position pos;
+        UndoStack stack;
+        position_from_text(&pos, PerftCases[g % (sizeof(PerftCases) / sizeof(PerftCases[0]))].text);
+        nnue->reset(pos);
+        for (Move m : games[g]) {
+            do_move(pos, m, stack);
+            nnue->pushed(stack.size);
+            int score = nnue->evaluate(pos, stack);
+            checksum += score;
+            evals++;
+            if (check && score != nnue_evaluate(pos)) {
+                mismatch = true;
+            }
+        }
+    }
+    return evals;
+}
+
+// Chaque noyau disponible contre le scalaire, puis la recherche avec et sans réseau
+static bool run_nnue(const char* filename) {
+    if (!nnue_load(filename)) {
+        std::cerr << "Réseau introuvable ou invalide : " << filename << " (le produire avec chess_nnuegen)" << std::endl;
+        return false;
+    }
+    NnueSimd best = nnue_simd();
+    std::vector<std::vector<Move>> games;
+    std::vector<Position> positions;
+    random_games(games, positions);
+    std::cout << "nnue (" << positions.size() << " positions, noyaux " << nnue_simd_name(best) << " par défaut)" << std::endl;
+
+    bool ok = true;
+    std::vector<int> reference;
+    int64_t referenceChecksum = 0;
+    for (int level = NNUE_SCALAR; level <= NNUE_AVX2; level++) {
+        NnueSimd simd = static_cast<NnueSimd>(level);
+        if (!nnue_use_simd(simd)) {
+            std::cout << "  " << std::left << std::setw(9) << nnue_simd_name(simd) << std::right << " absent de ce CPU" << std::endl;
+            continue;
+        }
+        // Évaluations complètes : accumulateur recalculé depuis toutes les pièces
+        std::vector<int> scores(positions.size());
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < positions.size(); i++) {
+            scores[i] = nnue_evaluate(positions[i]);
+        }
+        double fullSeconds = seconds_since(start);
+        if (reference.empty()) {
+            reference = scores;
+        }
+        bool same = scores == reference;
+
+        // Évaluations incrémentales : un coup ajouté à l'accumulateur du parent
+        int64_t checksum = 0;
+        bool mismatch = false;
+        replay_incremental(games, checksum, true, mismatch);
+        checksum = 0;
+        start = std::chrono::steady_clock::now();
+        uint64_t evals = 0;
+        for (int r = 0; r < 10; r++) {
+            evals += replay_incremental(games, checksum, false, mismatch);
+        }
+        double incrementalSeconds = seconds_since(start);
+        if (level == NNUE_SCALAR) {
+            referenceChecksum = checksum;
+        }
+        same = same && !mismatch && checksum == referenceChecksum;
+        ok = ok && same;
+        std::cout << "  " << std::left << std::setw(9) << nnue_simd_name(simd) << std::right
+                  << (same ? " identique  " : " ERREUR : scores différents  ")
+                  << static_cast<uint64_t>(fullSeconds > 0 ? positions.size() / fullSeconds : 0) << " évaluations complètes/s, "
+                  << static_cast<uint64_t>(incrementalSeconds > 0 ? evals / incrementalSeconds : 0) << " incrémentales/s" << std::endl;
+    }
+    nnue_use_simd(best);
+
+    // Recherche à profondeur fixe : noeuds par seconde avec l'évaluation matérielle et avec le réseau
+    for (int useNnue = 0; useNnue < 2; useNnue++) {
+        uint64_t nodes = 0;
+        double seconds = 0;
+        for (const PerftCase& c : PerftCases) {
+            Position pos;
+            position_from_text(&pos, c.text);
+            TT.clear();
+            SearchLimits limits;
+            limits.depth = NNUE_SEARCH_DEPTH;
+            limits.nnue = useNnue != 0;
+            SearchResult result = search(pos, limits);
+            nodes += result.nodes;
+            seconds += result.seconds;
+        }
+        std::cout << "  recherche " << (useNnue ? "réseau    " : "matériel  ") << " profondeur " << NNUE_SEARCH_DEPTH
+                  << " : " << std::setw(9) << nodes << " noeuds, "
+                  << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0) << " noeuds/s" << std::endl;
+    }
+    return ok;
+}
+
+static bool solver_loses(const Position& pos, int n);
+
+// Le joueur au trait peut-il prendre la dernière pièce adverse en au plus n demi-coups ?
+static bool solver_wins(const Position& pos, int n) {
+    Player them = pos.sideToMove == PLAYER1 ? PLAYER2 : PLAYER1;
+    MoveList moves;
+    generate_moves(pos, moves);
+    for (Move m : moves) {
+        if (move_captured(m) != EMPTY && pos.counts[them][EMPTY] == 1) {
+            return true;
+        }
+    }
+    if (n < 3) {
+        return false;
+    }
+    for (Move m : moves) {
+        Position child = pos;
+        apply_move(child, m);
+        if (solver_loses(child, n - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tous les coups du joueur au trait mènent-ils à un gain adverse, la partie finissant
+// en au plus n demi-coups ? Sans coup possible, la partie est nulle.
+static bool solver_loses(const Position& pos, int n) {
+    Player them = pos.sideToMove == PLAYER1 ? PLAYER2 : PLAYER1;
+    MoveList moves;
+    generate_moves(pos, moves);
+    if (n < 2 || moves.size == 0) {
+        return false;
+    }
+    for (Move m : moves) {
+        if (move_captured(m) != EMPTY && pos.counts[them][EMPTY] == 1) {
+            return false;
+        }
+        Position child = pos;
+        apply_move(child, m);
+        if (!solver_wins(child, n - 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Valeur exacte au sens des tables si la partie finit en au plus depth demi-coups, 0 sinon
+static int solve(const Position& pos, int depth) {
+    for (int n = 1; n <= depth; n++) {
+        if ((n & 1) ? solver_wins(pos, n) : solver_loses(pos, n)) {
+            return (n & 1) ? n : -n;
+        }
+    }
+    return 0;
+}
+
+static bool run_tables(const std::string& directory, int depth) {
+    std::cout << "tables" << std::endl;
+    int tables = tb_init(directory);
+    if (tables == 0) {
+        std::cerr << "Aucune table dans " << directory << " (les produire avec chess_tbgen)" << std::endl;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    Prng rng(2024);
+    uint64_t checked = 0, mismatches = 0;
+    for (int stmMask = 1; stmMask < 16; stmMask++) {
+        for (int otherMask = 1; otherMask < 16; otherMask++) {
+            if (popcount(stmMask) + popcount(otherMask) > tb_max_pieces()) {
+                continue;
+            }
+            for (int sample = 0; sample < TB_CHECK_SAMPLES; sample++) {
+                // Pièces posées au hasard sur des cases distinctes, joueur au trait au hasard
+                Position pos;
+                clear_position(&pos);
+                Player us = (rng.next() & 1) ? PLAYER1 : PLAYER2;
+                for (int side = 0; side < 2; side++) {
+                    Player player = side == 0 ? us : (us == PLAYER1 ? PLAYER2 : PLAYER1);
+                    int mask = side == 0 ? stmMask : otherMask;
+                    for (int type = QUEEN; type <= BISHOP; type++) {
+                        if (mask & (1 << (type - 1))) {
+                            int square;
+                            do {
+                                square = static_cast<int>(rng.next() % SQUARE_COUNT);
+                            } while (pos.squares[square] != 0);
+                            put_piece(&pos, square, static_cast<PieceType>(type), player);
+                        }
+                    }
+                }
+                set_side_to_move(&pos, us);
+                int value;
+                if (!tb_probe(pos, value)) {
+                    break; // Table absente
+                }
+                int expected = std::abs(value) <= depth ? value : 0;
+                int solved = solve(pos, depth);
+                checked++;
+                if (solved != expected) {
+                    if (mismatches++ < 10) {
+                        std::cout << "  " << position_to_text(&pos) << " : table " << value << ", solveur " << solved << std::endl;
+                    }
+                }
+            }
+        }
+    }
+    tb_free();
+    std::cout << "  " << tables << " tables, " << checked << " positions comparées au solveur (profondeur " << depth
+              << ") en " << seconds_since(start) << " s : " << mismatches << " écarts" << std::endl;
+    return mismatches == 0;
+}
+
+int main(int argc, char* argv[]) {
+    init_attacks();
+    init_zobrist();
+    TT.resize(16);
+
+    std::string mode = argc > 1 ? argv[1] : "all";
+    int depth = argc > 2 ? atoi(argv[2]) : 0;
+    if (mode == "nnue") {
+        return run_nnue(argc > 2 ? argv[2] : "chess_nnue.bin") ? 0 : 1;
+    }
+    if (mode == "tables") {
+        return run_tables(argc > 2 ? argv[2] : "tables", argc > 3 ? atoi(argv[3]) : TB_CHECK_DEPTH) ? 0 : 1;
+    }
+    if (mode == "mcts") {
+        run_mcts(depth > 0 ? depth : MCTS_DEFAULT_MOVETIME);
+        return 0;
+    }
+    if (mode != "perft" && mode != "search" && mode != "sizes" && mode != "all") {
+        std::cerr << "Usage : chess_bench [perft|search|sizes|all] [profondeur] ou chess_bench mcts [ms] ou chess_bench nnue [réseau] ou chess_bench tables [dossier] [profondeur]" << std::endl;
+        return 2;
+    }
+
+    bool ok = true;
+    if (mode == "perft" || mode == "all") {
+        ok = run_perft(depth > 0 ? std::min(depth, 6) : PERFT_DEFAULT_DEPTH);
+    }
+    if (mode == "search" || mode == "all") {
+        run_search(depth > 0 ? depth : SEARCH_DEFAULT_DEPTH);
+    }
+    if (mode == "sizes" || mode == "all") {
+        ok = run_sizes(depth > 0 ? std::min(depth, 5) : SIZES_DEFAULT_DEPTH) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_set>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "engine/attacks.h"
+#include "engine/movegen.h"
+#include "engine/search.h"
+#include "engine/tt.h"
+#include "engine/archive.h"
+#include "engine/game.h"
+#include "engine/book.h"
+
+// Construction et mesure du livre d'ouverture de book.h.
+// Usage : chess_book search LIVRE [--plies N] [--depth N] [--margin CP] [--width N] [--threads N]
+//         chess_book archive LIVRE ARCHIVE... [--plies N] [--min-games N]
+//         chess_book probe LIVRE [--probes N]
+//
+// search : depuis la position de départ, chaque coup est évalué par une recherche de
+// la position qui le suit ; les coups à moins de --margin centipions du meilleur (au
+// plus --width) entrent au livre, poids décroissant avec l'écart, et leurs positions
+// sont développées à leur tour jusqu'à --plies demi-coups.
+// archive : les --plies premiers coups des parties d'une archive (chess_selfplay
+// --archive), pondérés par le résultat pour le joueur qui les a joués : 2 par gain,
+// 1 par nulle ; un coup joué dans moins de --min-games parties est écarté.
+// probe : taille du livre, temps de projection, coups de la position de départ et
+// latence d'une consultation, mesurée sur des positions du livre et hors du livre.
+
+#define DEFAULT_PLIES 4
+#define DEFAULT_DEPTH 6
+#define DEFAULT_MARGIN 40
+#define DEFAULT_WIDTH 3
+#define DEFAULT_PROBES 2000000
+#define SEARCH_WEIGHT 100 // Poids du meilleur coup d'une position en mode search
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static int build_from_search(std::vector<BookEntry>& entries, int plies, int depth, int margin, int width, int threads) {
+    SearchLimits limits;
+    limits.depth = std::max(1, depth - 1);
+    limits.threads = threads;
+    limits.book = false;
+
+    std::vector<Position> frontier(1);
+    initialize_board(&frontier[0]);
+    std::unordered_set<uint64_t> seen = {frontier[0].state.key};
+    int searches = 0;
+    for (int ply = 0; ply < plies && !frontier.empty(); ply++) {
+        std::vector<Position> next;
+        for (const Position& pos : frontier) {
+            MoveList moves;
+            generate_moves(pos, moves);
+            Player them = (pos.sideToMove == PLAYER1) ? PLAYER2 : PLAYER1;
+            std::vector<std::pair<int, Move>> scored;
+            for (Move m : moves) {
+                if (move_captured(m) != EMPTY && pos.counts[them][EMPTY] == 1) {
+                    scored.push_back({SCORE_WIN, m}); // Dernière pièce adverse prise
+                    continue;
+                }
+                Position child = pos;
+                apply_move(child, m);
+                scored.push_back({-search(child, limits).score, m});
+                searches++;
+            }
+            std::stable_sort(scored.begin(), scored.end(), [](const std::pair<int, Move>& a, const std::pair<int, Move>& b) {
+                return a.first > b.first;
+            });
+            for (size_t i = 0; i < scored.size() && static_cast<int>(i) < width; i++) {
+                int gap = scored[0].first - scored[i].first;
+                if (gap > margin) {
+                    break;
+                }
+                int weight = margin > 0 ? 1 + (SEARCH_WEIGHT - 1) * (margin - gap) / margin : SEARCH_WEIGHT;
+                entries.push_back({pos.state.key, scored[i].second, static_cast<uint16_t>(weight), 1});
+                Position child = pos;
+                apply_move(child, scored[i].second);
+                if (hasRemainingPieces(&child, child.sideToMove) && seen.insert(child.state.key).second) {
+                    next.push_back(child);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return searches;
+}
+
+// Points d'un coup pour le joueur qui l'a joué, selon le résultat de la partie
+struct MoveTally {
+    uint32_t points = 0;
+    uint32_t games = 0;
+};
+
+static bool build_from_archives(std::vector<BookEntry>& entries, const std::vector<const char*>& archives, int plies, int minGames) {
+    std::map<std::pair<uint64_t, Move>, MoveTally> tallies;
+    uint64_t games = 0;
+    for (const char* filename : archives) {
+        ArchiveReader reader;
+        if (!reader.open(filename)) {
+            std::cerr << "Archive illisible : " << filename << std::endl;
+            return false;
+        }
+        ArchiveGame game;
+        while (reader.next(game)) {
+            Position pos;
+            if (game.result == RESULT_UNKNOWN || !unpack_position(game.position, &pos)) {
+                continue;
+            }
+            games++;
+            for (uint32_t i = 0; i < game.moveCount && static_cast<int>(i) < plies; i++) {
+                Move m = game.move(i);
+                if (!is_pseudo_legal(pos, m)) {
+                    break;
+                }
+                Player us = pos.sideToMove;
+                bool won = game.result == (us == PLAYER1 ? RESULT_PLAYER1_WINS : RESULT_PLAYER2_WINS);
+                MoveTally& tally = tallies[{pos.state.key, m}];
+                tally.points += won ? 2 : game.result == RESULT_DRAW ? 1 : 0;
+                tally.games++;
+                apply_move(pos, m);
+            }
+        }
+    }
+    for (const auto& item : tallies) {
+        if (item.second.games >= static_cast<uint32_t>(minGames) && item.second.points > 0) {
+            uint16_t weight = static_cast<uint16_t>(std::min<uint32_t>(65535, item.second.points));
+            entries.push_back({item.first.first, item.first.second, weight, item.second.games});
+        }
+    }
+    std::cout << games << " parties lues, " << tallies.size() << " coups distincts" << std::endl;
+    return true;
+}
+
+static int probe_book(const char* filename, int probes) {
+    auto start = Clock::now();
+    if (!book_init(filename)) {
+        std::cerr << "Livre introuvable ou invalide : " << filename << std::endl;
+        return 1;
+    }
+    std::cout << book_entries() << " entrées, " << book_size() << " octets, projeté en "
+              << seconds_since(start) * 1e6 << " µs" << std::endl;
+
+    Position root;
+    initialize_board(&root);
+    BookEntry moves[BOOK_MAX_MOVES];
+    int count = book_probe(root.state.key, moves, BOOK_MAX_MOVES);
+    uint32_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += moves[i].weight;
+    }
+    for (int i = 0; i < count; i++) {
+        std::cout << "    " << move_to_text(moves[i].move) << " poids " << moves[i].weight << " ("
+                  << 100.0 * moves[i].weight / total << " %), " << moves[i].samples << " parties ou recherches" << std::endl;
+    }
+
+    // Moitié de clés prises sur des lignes du livre, moitié de clés au hasard
+    Prng rng(2024);
+    std::vector<uint64_t> keys;
+    for (int i = 0; i < 1 << 14; i++) {
+        Position pos = root;
+        int plies = static_cast<int>(rng.next() % 8);
+        Move m;
+        for (int p = 0; p < plies && book_move(pos, m); p++) {
+            Position child = pos;
+            apply_move(child, m);
+            if (book_probe(child.state.key, moves, 1) == 0) {
+                break; // Feuille du livre : on reste sur la position connue
+            }
+            pos = child;
+        }
+        keys.push_back(pos.state.key);
+        keys.push_back(rng.next());
+    }
+    uint64_t hits = 0;
+    start = Clock::now();
+    for (int i = 0; i < probes; i++) {
+        hits += book_probe(keys[i % keys.size()], moves, BOOK_MAX_MOVES) > 0;
+    }
+    double seconds = seconds_since(start);
+    std::cout << probes << " consultations : " << seconds * 1e9 / probes << " ns chacune, "
+              << 100.0 * hits / probes << " % dans le livre" << std::endl;
+
+    Move m;
+    start = Clock::now();
+    bool found = book_move(root, m);
+    std::cout << "Coup de la position de départ : " << (found ? move_to_text(m) : std::string("aucun"))
+              << " en " << seconds_since(start) * 1e6 << " µs" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    init_attacks();
+    init_zobrist();
+    if (argc < 3) {
+        std::cerr << "Usage : chess_book search|archive|probe LIVRE [ARCHIVE...] [options]" << std::endl;
+        return 2;
+    }
+    std::string mode = argv[1];
+    const char* filename = argv[2];
+    int plies = DEFAULT_PLIES, depth = DEFAULT_DEPTH, margin = DEFAULT_MARGIN, width = DEFAULT_WIDTH;
+    int threads = 1, minGames = 1, probes = DEFAULT_PROBES;
+    std::vector<const char*> archives;
+    for (int i = 3; i < argc; i++) {
+        std::string option = argv[i];
+        if (option.compare(0, 2, "--") != 0) {
+            archives.push_back(argv[i]);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Valeur manquante pour " << option << std::endl;
+            return 2;
+        }
+        int value = atoi(argv[++i]);
+        if (option == "--plies") {
+            plies = value;
+        } else if (option == "--depth") {
+            depth = value;
+        } else if (option == "--margin") {
+            margin = value;
+        } else if (option == "--width") {
+            width = value;
+        } else if (option == "--threads") {
+            threads = value;
+        } else if (option == "--min-games") {
+            minGames = value;
+        } else if (option == "--probes") {
+            probes = value;
+        } else {
+            std::cerr << "Option inconnue : " << option << std::endl;
+            return 2;
+        }
+    }
+
+    if (mode == "probe") {
+        return probe_book(filename, std::max(1, probes));
+    }
+    auto start = Clock::now();
+    std::vector<BookEntry> entries;
+    if (mode == "search") {
+        TT.resize(64);
+        int searches = build_from_search(entries, plies, depth, margin, width, threads);
+        std::cout << searches << " recherches à la profondeur " << depth - 1 << std::endl;
+    } else if (mode == "archive") {
+        if (archives.empty()) {
+            std::cerr << "Aucune archive donnée." << std::endl;
+            return 2;
+        }
+        if (!build_from_archives(entries, archives, plies, minGames)) {
+            return 1;
+        }
+    } else {
+        std::cerr << "Mode inconnu : " << mode << std::endl;
+        return 2;
+    }
+    if (!book_write(filename, entries)) {
+        std::cerr << "Impossible d'écrire " << filename << std::endl;
+        return 1;
+    }
+    std::unordered_set<uint64_t> positions;
+    for (const BookEntry& entry : entries) {
+        positions.insert(entry.key);
+    }
+    std::cout << "Livre écrit dans " << filename << " : " << positions.size() << " positions, " << entries.size()
+              << " entrées, " << BOOK_HEADER_SIZE + entries.size() * BOOK_ENTRY_SIZE << " octets, construit en "
+              << seconds_since(start) << " s" << std::endl;
+    return 0;
+}
@@ -1,188 +1,82 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
-#include <vector>
-#include <fstream>  // Pour ifstream et ofstream
-#include <cstdlib>  // Pour abs()
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include "engine/attacks.h"
+#include "engine/game.h"
+#include "engine/movegen.h"
+#include "engine/journal.h"
+#include "engine/search.h"
+#include "engine/tt.h"
+#include "engine/tablebase.h"
+#include "engine/worker.h"
+#include "engine/instrument.h"
+#include "engine/nnue.h"
+#include "engine/book.h"
+#include "assets.h"
 
-#define BOARD_SIZE 8
 #define TILE_SIZE 100 // Taille des cases du plateau
 
-// Enumération pour les types de pièces
-typedef enum { EMPTY, QUEEN, KNIGHT, ROOK, BISHOP } PieceType;
-
-// Enumération pour les joueurs
-typedef enum { PLAYER1, PLAYER2 } Player;
-
-// Structure pour représenter une pièce
-struct Piece {
-    PieceType type;
-    Player player;
-    Piece(PieceType t, Player p) : type(t), player(p) {}
-};
-
-// Structure pour représenter le plateau
-struct Board {
-    Piece* grid[BOARD_SIZE][BOARD_SIZE];
+// Atlas de l'interface : le plateau et les huit pièces dans une seule texture. Pour
+// chaque image on garde sa zone dans l'atlas et son rectangle à l'écran (le plateau
+// entier, ou la pièce dans une case placée à l'origine).
+struct ImageAtlas {
+    sf::Texture texture;
+    sf::FloatRect source[ATLAS_SPRITES];
+    sf::FloatRect quad[ATLAS_SPRITES];
 };
 
-// Structure pour représenter une partie
-struct Game {
-    Board board;
-    Player currentPlayer;
-};
-
-// Fonction pour initialiser le plateau
-void initialize_board(Board* board) {
-    // Initialiser toutes les cases à nullptr (cases vides)
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            board->grid[i][j] = nullptr; // Toutes les cases sont vides au départ
-        }
-    }
-
-    // Placement des pièces
-    board->grid[0][0] = new Piece(ROOK, PLAYER1);
-    board->grid[0][1] = new Piece(KNIGHT, PLAYER1);
-    board->grid[0][2] = new Piece(BISHOP, PLAYER1);
-    board->grid[0][3] = new Piece(QUEEN, PLAYER1);
-
-    board->grid[7][7] = new Piece(ROOK, PLAYER2);
-    board->grid[7][6] = new Piece(KNIGHT, PLAYER2);
-    board->grid[7][5] = new Piece(BISHOP, PLAYER2);
-    board->grid[7][4] = new Piece(QUEEN, PLAYER2);
-}
-
-// Fonction pour afficher le plateau dans la console
-void print_board(Board* board) {
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (board->grid[y][x] != nullptr) {
-                std::cout << (board->grid[y][x]->type + 1) << " "; // Afficher le type de pièce
-            } else {
-                std::cout << "0 "; // Afficher 0 pour une case vide
-            }
-        }
-        std::cout << std::endl; // Nouvelle ligne pour chaque rangée
-    }
-}
-
-// Vérifier si un mouvement est valide
-int is_valid_move(PieceType type, int fromX, int fromY, int toX, int toY) {
-    // Validation basique des mouvements pour chaque type de pièce
-    switch (type) {
-        case QUEEN:
-            return (fromX == toX || fromY == toY || abs(fromX - toX) == abs(fromY - toY)); // Déplacement en ligne ou en diagonale
-        case KNIGHT:
-            return (abs(fromX - toX) == 2 && abs(fromY - toY) == 1) || (abs(fromX - toX) == 1 && abs(fromY - toY) == 2); // Mouvement en "L"
-        case ROOK:
-            return (fromX == toX || fromY == toY); // Déplacement en ligne droite
-        case BISHOP:
-            return (abs(fromX - toX) == abs(fromY - toY)); // Déplacement en diagonale
-        default:
-            return 0; // Mouvement invalide
-    }
-}
-
-// Enregistrer la partie dans un fichier
-void save_game(Game* game, const char* filename) {
-    std::ofstream file(filename);
-    if (file.is_open()) {
-        for (int y = 0; y < BOARD_SIZE; y++) {
-            for (int x = 0; x < BOARD_SIZE; x++) {
-                if (game->board.grid[y][x] != nullptr) {
-                    file << game->board.grid[y][x]->type << " " << game->board.grid[y][x]->player << " ";
-                } else {
-                    file << "-1 "; // -1 pour une case vide
-                }
-            }
-            file << std::endl;
-        }
-        file << game->currentPlayer << std::endl;
-        file.close();
-    } else {
-        std::cerr << "Erreur d'ouverture du fichier pour la sauvegarde." << std::endl;
+// Charger l'atlas préparé par chess_pack_assets : une projection du fichier et un seul
+// envoi des pixels à la carte graphique, sans décoder d'image
+bool load_image_atlas(ImageAtlas& atlas, const std::string& filename) {
+    AtlasFile file;
+    if (!file.open(filename.c_str()) || !atlas.texture.create(file.width(), file.height())) {
+        return false;
     }
-}
-
-// Charger une partie à partir d'un fichier
-void load_game(Game* game, const char* filename) {
-    std::ifstream file(filename);
-    if (file.is_open()) {
-        for (int y = 0; y < BOARD_SIZE; y++) {
-            for (int x = 0; x < BOARD_SIZE; x++) {
-                int type, player;
-                file >> type >> player;
-                if (type != -1) {
-                    game->board.grid[y][x] = new Piece(static_cast<PieceType>(type), static_cast<Player>(player));
-                } else {
-                    game->board.grid[y][x] = nullptr; // Case vide
-                }
-            }
-        }
-        int currentPlayer;
-        file >> currentPlayer;
-        game->currentPlayer = static_cast<Player>(currentPlayer);
-        file.close();
-    } else {
-        std::cerr << "Erreur d'ouverture du fichier pour le chargement." << std::endl;
-    }
-}
-
-// Effectuer un mouvement
-void make_move(Game* game, int fromX, int fromY, int toX, int toY) {
-    Piece* piece = game->board.grid[fromY][fromX];
-    if (piece != nullptr && piece->player == game->currentPlayer) {
-        if (is_valid_move(piece->type, fromX, fromY, toX, toY)) {
-            delete game->board.grid[toY][toX]; // Supprimer la pièce de destination s'il y en a une
-            game->board.grid[toY][toX] = piece; // Déplacer la pièce
-            game->board.grid[fromY][fromX] = nullptr; // Vider la case de départ
-            game->currentPlayer = (game->currentPlayer == PLAYER1) ? PLAYER2 : PLAYER1; // Changer de joueur
+    atlas.texture.update(file.pixels());
+    atlas.texture.setSmooth(true);
+    for (int i = 0; i < ATLAS_SPRITES; i++) {
+        const AtlasRect& r = file.sprite(i);
+        atlas.source[i] = sf::FloatRect(r.x, r.y, r.width, r.height);
+        if (i == ATLAS_BOARD) {
+            atlas.quad[i] = sf::FloatRect(0, 0, BOARD_SIZE * TILE_SIZE, BOARD_SIZE * TILE_SIZE);
         } else {
-            std::cout << "Mouvement invalide!" << std::endl;
+            // Les pièces sont centrées dans une case de ATLAS_CELL_SIZE pixels
+            float scale = static_cast<float>(TILE_SIZE) / ATLAS_CELL_SIZE;
+            float width = r.width * scale, height = r.height * scale;
+            atlas.quad[i] = sf::FloatRect((TILE_SIZE - width) / 2, (TILE_SIZE - height) / 2, width, height);
         }
-    } else {
-        std::cout << "Aucune pièce à déplacer ou mauvaise pièce!" << std::endl;
     }
+    return true;
 }
 
-// Fonction pour dessiner le plateau et les pièces
-void draw_board(sf::RenderWindow& window, Board* board, sf::Sprite boardSprite, sf::Sprite pieceSprites[2][4]) {
-    window.draw(boardSprite); // Dessiner le plateau
-
-    float squareSize = static_cast<float>(TILE_SIZE); // Taille d'une case
-
-    // Dessiner les pièces
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (board->grid[y][x] != nullptr) {
-                int player = board->grid[y][x]->player;
-                int type = board->grid[y][x]->type - 1; // Ajuster l'index pour correspondre au tableau
-
-                // Ajuster la taille et la position de la pièce
-                sf::Sprite& pieceSprite = pieceSprites[player][type];
-                float scaleFactor = squareSize / std::max(pieceSprite.getTexture()->getSize().x, pieceSprite.getTexture()->getSize().y);
-                pieceSprite.setScale(scaleFactor, scaleFactor);
-
-                // Centrer la pièce dans la case
-                float pieceWidth = pieceSprite.getGlobalBounds().width;
-                float pieceHeight = pieceSprite.getGlobalBounds().height;
-                float offsetX = (squareSize - pieceWidth) / 2;
-                float offsetY = (squareSize - pieceHeight) / 2;
-
-                pieceSprite.setPosition(x * squareSize + offsetX, y * squareSize + offsetY);
-                window.draw(pieceSprite);
-            }
-        }
-    }
+// Ajouter une image de l'atlas au tableau de sommets, décalée de (x, y)
+void append_sprite(sf::VertexArray& vertices, const ImageAtlas& atlas, int index, float x, float y) {
+    const sf::FloatRect& q = atlas.quad[index];
+    const sf::FloatRect& t = atlas.source[index];
+    x += q.left;
+    y += q.top;
+    vertices.append(sf::Vertex(sf::Vector2f(x, y), sf::Vector2f(t.left, t.top)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + q.width, y), sf::Vector2f(t.left + t.width, t.top)));
+    vertices.append(sf::Vertex(sf::Vector2f(x + q.width, y + q.height), sf::Vector2f(t.left + t.width, t.top + t.height)));
+    vertices.append(sf::Vertex(sf::Vector2f(x, y + q.height), sf::Vector2f(t.left, t.top + t.height)));
 }
 
-// Libérer la mémoire allouée aux pièces
-void free_board(Board* board) {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            delete board->grid[i][j]; // Libérer chaque pièce
+// Fonction pour dessiner le plateau et les pièces : tout part en un seul appel de
+// dessin, le tableau de sommets est réutilisé d'une image à l'autre
+void draw_board(sf::RenderWindow& window, const Position* pos, const ImageAtlas& atlas, sf::VertexArray& vertices) {
+    vertices.clear();
+    append_sprite(vertices, atlas, ATLAS_BOARD, 0, 0); // Le plateau
+    for (int player = 0; player < 2; player++) {
+        Bitboard occupied = pos->occupied[player];
+        while (occupied) {
+            int square = pop_lsb(occupied);
+            append_sprite(vertices, atlas, atlas_piece(player, code_type(pos->squares[square])),
+                          square_x(square) * TILE_SIZE, square_y(square) * TILE_SIZE);
         }
     }
+    window.draw(vertices, sf::RenderStates(&atlas.texture));
 }
 
 // Fonction pour afficher le menu principal
@@ -191,85 +85,138 @@ void displayMenu() {
     std::cout << "2. Nouvelle partie contre l'IA" << std::endl;
     std::cout << "3. Charger une partie" << std::endl;
     std::cout << "4. Quitter" << std::endl;
+    std::cout << "5. Nouvelle partie contre l'IA Monte-Carlo" << std::endl;
     std::cout << "Choisissez une option : ";
 }
 
-// Fonction pour vérifier si un joueur a encore des pièces
-bool hasRemainingPieces(Board* board, Player player) {
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (board->grid[y][x] != nullptr && board->grid[y][x]->player == player) {
-                return true;
-            }
-        }
+// Mouvement de l'IA : coup cherché par le thread de recherche, joué ici
+void ai_move(Game* game, const SearchResult& result) {
+    if (result.bestMove == MOVE_NONE) {
+        return;
     }
-    return false;
-}
+    Move m = result.bestMove;
+    make_move(game, square_x(move_from(m)), square_y(move_from(m)), square_x(move_to(m)), square_y(move_to(m)));
 
-// Fonction simple pour le mouvement de l'IA (à améliorer pour une vraie IA)
-void ai_move(Game* game) {
-    std::vector<std::pair<int, int>> pieces;
-    std::vector<std::pair<int, int>> moves;
+    // Compte rendu selon l'origine du coup : livre, tables de finales, Monte-Carlo ou alpha-bêta
+    if (result.bookMove) {
+        std::cout << "IA : coup lu dans le livre d'ouverture" << std::endl;
+        return;
+    }
+    if (result.depth == 0 && result.tbHits > 0) {
+        std::cout << "IA : coup lu dans les tables de finales, score " << result.score << std::endl;
+        return;
+    }
+    if (result.playouts > 0) {
+        std::cout << "IA Monte-Carlo : " << result.playouts << " simulations, "
+                  << static_cast<uint64_t>(result.seconds > 0 ? result.playouts / result.seconds : 0)
+                  << " simulations/s, " << static_cast<uint64_t>(result.nps) << " positions/s, profondeur de l'arbre "
+                  << result.depth << ", score " << result.score << std::endl;
+        return;
+    }
+    std::cout << "IA : profondeur " << result.depth << ", score " << result.score
+              << ", " << result.nodes << " noeuds, " << static_cast<uint64_t>(result.nps) << " noeuds/s"
+              << ", branchement effectif " << result.branching << ", tables de finales " << result.tbHits << std::endl;
+    if (result.ttProbes > 0) {
+        std::cout << "    quiescence " << result.qnodes << " noeuds, table de transposition "
+                  << 100.0 * result.ttHits / result.ttProbes << " % de succès, coupures au premier coup "
+                  << (result.cutoffs > 0 ? 100.0 * result.firstMoveCutoffs / result.cutoffs : 0) << " %" << std::endl;
+    }
+    for (const DepthReport& it : result.iterations) {
+        std::cout << "    profondeur " << it.depth << " atteinte en " << it.seconds * 1000 << " ms (" << it.nodes << " noeuds)" << std::endl;
+    }
+    for (size_t i = 0; i < result.threadNps.size(); i++) {
+        std::cout << "    thread " << i << " : " << static_cast<uint64_t>(result.threadNps[i]) << " noeuds/s" << std::endl;
+    }
+}
 
-    // Trouver toutes les pièces de l'IA
-    for (int y = 0; y < BOARD_SIZE; y++) {
-        for (int x = 0; x < BOARD_SIZE; x++) {
-            if (game->board.grid[y][x] != nullptr && game->board.grid[y][x]->player == PLAYER2) {
-                pieces.push_back({x, y});
-            }
-        }
+// Réponse attendue de l'adversaire : le meilleur coup gardé dans la table de transposition
+Move predicted_reply(const Position& pos) {
+    TTData entry;
+    if (TT.probe(pos.state.key, entry) && entry.move != MOVE_NONE && is_pseudo_legal(pos, entry.move)) {
+        return entry.move;
     }
+    return MOVE_NONE;
+}
 
-    // Trouver tous les mouvements possibles
-    for (const auto& piece : pieces) {
-        for (int toY = 0; toY < BOARD_SIZE; toY++) {
-            for (int toX = 0; toX < BOARD_SIZE; toX++) {
-                if (is_valid_move(game->board.grid[piece.second][piece.first]->type, piece.first, piece.second, toX, toY)) {
-                    moves.push_back({toX, toY});
-                }
+int main(int argc, char* argv[]) {
+    sf::Clock startupClock; // Temps de démarrage : jusqu'à la fenêtre prête à dessiner
+    init_attacks();
+    init_zobrist();
+
+    // Options : --depth N, --nodes N, --movetime MS et --threads N pour régler la
+    // recherche de l'IA, --hash N pour la taille de la table de transposition en Mo,
+    // --tables DOSSIER pour les tables de finales (produites par chess_tbgen),
+    // --save FICHIER pour le journal ouvert par la touche S, --assets FICHIER pour un
+    // autre atlas que celui placé à côté de l'exécutable, --stats FICHIER pour les
+    // mesures écrites en JSON par la touche I, --nnue FICHIER pour évaluer avec un
+    // réseau (produit par chess_nnuegen), --book FICHIER pour le livre d'ouverture
+    // (produit par chess_book).
+    // Par défaut l'IA approfondit tant qu'elle a du temps, une seconde au plus par coup.
+    SearchLimits aiLimits;
+    aiLimits.depth = MAX_PLY - 1;
+    aiLimits.movetime = 1000;
+    size_t hashMegabytes = 16;
+    std::string tableDirectory = "tables";
+    std::string saveFile = "partie.jrn";
+    std::string statsFile = "chess_stats.json";
+    std::string atlasFile = executable_directory(argv[0]) + ATLAS_FILE_NAME;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--depth") {
+            aiLimits.depth = atoi(argv[i + 1]);
+        } else if (option == "--nodes") {
+            aiLimits.nodes = strtoull(argv[i + 1], nullptr, 10);
+        } else if (option == "--movetime") {
+            aiLimits.movetime = atoi(argv[i + 1]);
+        } else if (option == "--threads") {
+            aiLimits.threads = atoi(argv[i + 1]);
+        } else if (option == "--hash") {
+            hashMegabytes = strtoull(argv[i + 1], nullptr, 10);
+        } else if (option == "--tables") {
+            tableDirectory = argv[i + 1];
+        } else if (option == "--save") {
+            saveFile = argv[i + 1];
+        } else if (option == "--stats") {
+            statsFile = argv[i + 1];
+        } else if (option == "--nnue") {
+            if (nnue_load(argv[i + 1])) {
+                std::cout << "Réseau d'évaluation chargé, noyaux " << nnue_simd_name(nnue_simd()) << std::endl;
+            } else {
+                std::cerr << "Réseau introuvable ou invalide : " << argv[i + 1] << std::endl;
+            }
+        } else if (option == "--book") {
+            if (book_init(argv[i + 1])) {
+                std::cout << "Livre d'ouverture chargé : " << book_entries() << " entrées" << std::endl;
+            } else {
+                std::cerr << "Livre introuvable ou invalide : " << argv[i + 1] << std::endl;
             }
+        } else if (option == "--assets") {
+            atlasFile = argv[i + 1];
         }
     }
-
-    // Choisir un mouvement aléatoire
-    if (!moves.empty()) {
-        int randomPieceIndex = rand() % pieces.size();
-        int randomMoveIndex = rand() % moves.size();
-        make_move(game, pieces[randomPieceIndex].first, pieces[randomPieceIndex].second, moves[randomMoveIndex].first, moves[randomMoveIndex].second);
+    TT.resize(hashMegabytes);
+    int tableCount = tb_init(tableDirectory);
+    if (tableCount > 0) {
+        std::cout << tableCount << " tables de finales chargées (jusqu'à " << tb_max_pieces() << " pièces)" << std::endl;
     }
-}
 
-int main() {
     sf::RenderWindow window(sf::VideoMode(BOARD_SIZE * TILE_SIZE, BOARD_SIZE * TILE_SIZE), "Jeu d'Echecs");
 
-    // Chargement des textures pour le plateau et les pièces
-    sf::Texture boardTexture, pieceTextures[2][4];
-    boardTexture.loadFromFile("/Users/andreea/Documents/echec2/images/board.png");
-    
-    pieceTextures[PLAYER1][QUEEN-1].loadFromFile("/Users/andreea/Documents/echec2/images/player1_queen.png");
-    pieceTextures[PLAYER1][KNIGHT-1].loadFromFile("/Users/andreea/Documents/echec2/images/player1_knight.png");
-    pieceTextures[PLAYER1][ROOK-1].loadFromFile("/Users/andreea/Documents/echec2/images/player1_rook.png");
-    pieceTextures[PLAYER1][BISHOP-1].loadFromFile("/Users/andreea/Documents/echec2/images/player1_bishop.png");
-    
-    pieceTextures[PLAYER2][QUEEN-1].loadFromFile("/Users/andreea/Documents/echec2/images/player2_queen.png");
-    pieceTextures[PLAYER2][KNIGHT-1].loadFromFile("/Users/andreea/Documents/echec2/images/player2_knight.png");
-    pieceTextures[PLAYER2][ROOK-1].loadFromFile("/Users/andreea/Documents/echec2/images/player2_rook.png");
-    pieceTextures[PLAYER2][BISHOP-1].loadFromFile("/Users/andreea/Documents/echec2/images/player2_bishop.png");
-
-    sf::Sprite boardSprite(boardTexture);
-    boardSprite.setScale(
-        (float)(BOARD_SIZE * TILE_SIZE) / boardTexture.getSize().x,
-        (float)(BOARD_SIZE * TILE_SIZE) / boardTexture.getSize().y
-    );
+    window.setVerticalSyncEnabled(true);
 
-    sf::Sprite pieceSprites[2][4];
-    for (int player = 0; player < 2; player++) {
-        for (int type = 0; type < 4; type++) {
-            pieceSprites[player][type] = sf::Sprite(pieceTextures[player][type]);
-        }
+    // Chargement des images : l'atlas préparé à la construction
+    sf::Clock atlasClock;
+    ImageAtlas atlas;
+    if (!load_image_atlas(atlas, atlasFile)) {
+        std::cerr << "Atlas des images introuvable ou invalide : " << atlasFile
+                  << " (le produire avec chess_pack_assets)" << std::endl;
+        return 1;
     }
+    std::cout << "Démarrage : " << startupClock.getElapsedTime().asMicroseconds() / 1000.0 << " ms, dont "
+              << atlasClock.getElapsedTime().asMicroseconds() / 1000.0 << " ms pour l'atlas" << std::endl;
 
     Game game;
+    JournalWriter journal; // Ouvert par la première sauvegarde ou au chargement d'un journal
     bool gameStarted = false;
     bool playingAgainstAI = false;
 
@@ -280,13 +227,13 @@ int main() {
 
         switch (choice) {
             case 1: // Nouvelle partie (2 joueurs)
-                initialize_board(&game.board);
-                game.currentPlayer = PLAYER1;
+                initialize_board(&game.pos);
+                game.keys.clear();
                 gameStarted = true;
                 break;
             case 2: // Nouvelle partie contre l'IA
-                initialize_board(&game.board);
-                game.currentPlayer = PLAYER1;
+                initialize_board(&game.pos);
+                game.keys.clear();
                 gameStarted = true;
                 playingAgainstAI = true;
                 break;
@@ -294,12 +241,26 @@ int main() {
                 std::string filename;
                 std::cout << "Entrez le nom du fichier de sauvegarde : ";
                 std::cin >> filename;
-                load_game(&game, filename.c_str());
+                if (journal.resume(filename.c_str(), &game)) {
+                    game.writer = &journal; // Les coups suivants s'ajoutent au même journal
+                    saveFile = filename;
+                    std::cout << "Journal repris." << std::endl;
+                } else if (!load_game(&game, filename.c_str())) { // Ancienne sauvegarde texte
+                    std::cout << "Impossible de charger " << filename << ", retour au menu." << std::endl;
+                    break;
+                }
                 gameStarted = true;
                 break;
             }
             case 4: // Quitter
                 return 0;
+            case 5: // Nouvelle partie contre l'IA Monte-Carlo
+                initialize_board(&game.pos);
+                game.keys.clear();
+                gameStarted = true;
+                playingAgainstAI = true;
+                aiLimits.engine = ENGINE_MCTS;
+                break;
             default:
                 std::cout << "Option invalide. Veuillez réessayer." << std::endl;
         }
@@ -309,73 +270,147 @@ int main() {
     bool isPieceSelected = false;
     int selectedX = -1, selectedY = -1;
 
+    sf::VertexArray vertices(sf::Quads);
+    sf::RectangleShape selector(sf::Vector2f(TILE_SIZE, TILE_SIZE));
+    selector.setFillColor(sf::Color(255, 255, 0, 128)); // Jaune semi-transparent
+
+    // L'IA cherche sur son propre thread ; pendant le tour du joueur elle réfléchit à la
+    // position qui suivrait la réponse qu'elle attend
+    SearchWorker worker;
+    bool aiThinking = false;
+
+    // Rendu à la demande : on ne redessine que si le plateau ou la sélection a changé,
+    // et le reste du temps le thread dort dans waitEvent
+    bool dirty = true;
+
     // Boucle principale du jeu
     while (window.isOpen()) {
+        if (dirty) {
+            CHESS_TIMED(TIMER_FRAME);
+            window.clear();
+            draw_board(window, &game.pos, atlas, vertices);
+
+            // Dessiner un indicateur pour la pièce sélectionnée
+            if (isPieceSelected) {
+                selector.setPosition(selectedX * TILE_SIZE, selectedY * TILE_SIZE);
+                window.draw(selector);
+            }
+
+            window.display();
+            dirty = false;
+        }
+
+        // Vérifier s'il y a un gagnant
+        if (!hasRemainingPieces(&game.pos, PLAYER1)) {
+            std::cout << "Le joueur 2 a gagné !" << std::endl;
+            window.close();
+            break;
+        } else if (!hasRemainingPieces(&game.pos, PLAYER2)) {
+            std::cout << "Le joueur 1 a gagné !" << std::endl;
+            window.close();
+            break;
+        } else if (isThreefoldRepetition(&game)) {
+            std::cout << "Partie nulle par triple répétition." << std::endl;
+            window.close();
+            break;
+        }
+
+        // Tour de l'IA : lancer la recherche, puis regarder sans attendre si elle a fini
+        bool aiTurn = playingAgainstAI && game.pos.sideToMove == PLAYER2;
+        if (aiTurn && !aiThinking) {
+            worker.go(game.pos, game.keys, aiLimits);
+            aiThinking = true;
+        }
+        SearchResult result;
+        if (aiThinking && worker.poll(result)) {
+            aiThinking = false;
+            ai_move(&game, result);
+            dirty = true;
+            // La réflexion sur le temps adverse remplit la table de transposition,
+            // qui ne sert qu'à l'alpha-bêta
+            Move reply = aiLimits.engine == ENGINE_ALPHA_BETA ? predicted_reply(game.pos) : MOVE_NONE;
+            if (reply != MOVE_NONE && hasRemainingPieces(&game.pos, PLAYER1)) {
+                worker.ponder(game.pos, game.keys, reply, aiLimits);
+            }
+            continue;
+        }
+
+        // Pendant que l'IA cherche, la fenêtre reste servie : on relève les événements
+        // toutes les 10 ms ; sinon on dort dans waitEvent jusqu'au prochain
         sf::Event event;
-        while (window.pollEvent(event)) {
+        if (aiThinking) {
+            if (!window.pollEvent(event)) {
+                sf::sleep(sf::milliseconds(10));
+                continue;
+            }
+        } else if (!window.waitEvent(event)) {
+            break;
+        }
+        do {
             if (event.type == sf::Event::Closed)
                 window.close();
-            else if (event.type == sf::Event::MouseButtonPressed) {
+            else if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus)
+                dirty = true;
+            else if (event.type == sf::Event::MouseButtonPressed && !aiTurn) {
                 if (event.mouseButton.button == sf::Mouse::Left) {
                     int x = event.mouseButton.x / TILE_SIZE;
                     int y = event.mouseButton.y / TILE_SIZE;
 
-                    if (!isPieceSelected) {
+                    if (!on_board(x, y)) {
+                        // Clic hors du plateau (fenêtre agrandie) : ignoré
+                    } else if (!isPieceSelected) {
                         // Sélectionner une pièce
-                        if (game.board.grid[y][x] != nullptr && game.board.grid[y][x]->player == game.currentPlayer) {
+                        uint8_t code = game.pos.squares[square_of(x, y)];
+                        if (code != 0 && code_player(code) == game.pos.sideToMove) {
                             selectedX = x;
                             selectedY = y;
                             isPieceSelected = true;
+                            dirty = true;
                         }
                     } else {
                         // Déplacer la pièce sélectionnée
-                        make_move(&game, selectedX, selectedY, x, y);
+                        if (!make_move(&game, selectedX, selectedY, x, y)) {
+                            std::cout << "Mouvement invalide!" << std::endl;
+                        }
                         isPieceSelected = false;
+                        dirty = true;
                     }
                 }
             }
             else if (event.type == sf::Event::KeyPressed) {
                 if (event.key.code == sf::Keyboard::S) {
-                    // Sauvegarder la partie
-                    std::string filename;
-                    std::cout << "Entrez le nom du fichier pour la sauvegarde : ";
-                    std::cin >> filename;
-                    save_game(&game, filename.c_str());
-                    std::cout << "Partie sauvegardée." << std::endl;
+                    // Sauvegarder la partie : la première fois on ouvre un journal, ensuite
+                    // chaque coup y est ajouté et S ne fait qu'écrire ce qui reste en mémoire.
+                    // Le disque n'est touché que par le thread d'écriture.
+                    if (!journal.is_running() && journal.start(saveFile, game.pos)) {
+                        game.writer = &journal;
+                    }
+                    journal.request_flush();
+                } else if (event.key.code == sf::Keyboard::I) {
+                    // Exporter les mesures : compteurs de recherche, images, coups, sauvegardes
+                    if (instrument_dump(statsFile.c_str())) {
+                        std::cout << "Mesures écrites dans " << statsFile << std::endl;
+                    } else {
+                        std::cerr << "Impossible d'écrire " << statsFile << std::endl;
+                    }
                 }
             }
-        }
-
-        // Vérifier s'il y a un gagnant
-        if (!hasRemainingPieces(&game.board, PLAYER1)) {
-            std::cout << "Le joueur 2 a gagné !" << std::endl;
-            window.close();
-        } else if (!hasRemainingPieces(&game.board, PLAYER2)) {
-            std::cout << "Le joueur 1 a gagné !" << std::endl;
-            window.close();
-        }
-
-        // Mouvement de l'IA si c'est son tour
-        if (playingAgainstAI && game.currentPlayer == PLAYER2) {
-            ai_move(&game);
-        }
-
-        window.clear();
-        draw_board(window, &game.board, boardSprite, pieceSprites);
-
-        // Dessiner un indicateur pour la pièce sélectionnée
-        if (isPieceSelected) {
-            sf::RectangleShape selector(sf::Vector2f(TILE_SIZE, TILE_SIZE));
-            selector.setFillColor(sf::Color(255, 255, 0, 128)); // Jaune semi-transparent
-            selector.setPosition(selectedX * TILE_SIZE, selectedY * TILE_SIZE);
-            window.draw(selector);
-        }
-
-        window.display();
+        } while (window.pollEvent(event));
     }
 
-    // Libérer la mémoire
-    free_board(&game.board);
+    worker.stop();
+    if (worker.ponder_hits() > 0) {
+        std::cout << "Réflexion : " << worker.ponder_hits() << " coup(s) joué(s) sans nouvelle recherche" << std::endl;
+    }
+#ifdef CHESS_INSTRUMENT
+    const Histogram& frameTimes = instrument_timer(TIMER_FRAME); // Microsecondes
+    if (frameTimes.count() > 0) {
+        std::cout << "Rendu : " << frameTimes.count() << " images, " << frameTimes.mean() / 1000.0
+                  << " ms en moyenne, " << frameTimes.percentile(99) / 1000.0 << " ms au 99e centile, "
+                  << frameTimes.max() / 1000.0 << " ms au plus" << std::endl;
+    }
+#endif
 
     return 0;
 }
+
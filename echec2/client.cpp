@@ -0,0 +1,143 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Client de test de chess_server, à la place du vrai frontal.
+// Usage : chess_client --socket CHEMIN [--sessions N] [--plies N] [--depth N] [--shutdown 1]
+//
+// Ouvre N sessions qui jouent chacune le moteur contre lui-même pendant un nombre fixé
+// de demi-coups, toutes en même temps : chaque réponse "bestmove" est renvoyée aussitôt
+// en "move" suivi d'un nouveau "go". Donne ensuite les latences vues du client et
+// celles mesurées par le serveur.
+
+typedef std::chrono::steady_clock Clock;
+
+struct ClientSession {
+    Clock::time_point sent; // Envoi du dernier go
+    int plies = 0;
+};
+
+static bool send_text(int fd, const std::string& text) {
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t n = write(fd, text.data() + written, text.size() - written);
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    int sessionCount = 100, maxPlies = 20, depth = 3;
+    bool shutdown = false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--socket") {
+            path = argv[i + 1];
+        } else if (option == "--sessions") {
+            sessionCount = std::max(1, atoi(argv[i + 1]));
+        } else if (option == "--plies") {
+            maxPlies = std::max(1, atoi(argv[i + 1]));
+        } else if (option == "--depth") {
+            depth = std::max(1, atoi(argv[i + 1]));
+        } else if (option == "--shutdown") {
+            shutdown = atoi(argv[i + 1]) != 0;
+        }
+    }
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Usage : chess_client --socket CHEMIN [--sessions N] [--plies N] [--depth N] [--shutdown 1]" << std::endl;
+        return 2;
+    }
+    strcpy(address.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Connexion impossible à " << path << std::endl;
+        return 1;
+    }
+    FILE* in = fdopen(dup(fd), "r");
+
+    std::string go = " depth " + std::to_string(depth) + "\n";
+    std::vector<ClientSession> sessions(sessionCount);
+    std::string burst;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < sessionCount; i++) {
+        std::string id = "s" + std::to_string(i);
+        burst += "new " + id + "\ngo " + id + go;
+        sessions[i].sent = start;
+    }
+    send_text(fd, burst);
+
+    std::vector<double> latencies; // Millisecondes, du go au bestmove
+    int finished = 0, errors = 0;
+    char* buffer = nullptr;
+    size_t capacity = 0;
+    while (finished < sessionCount && getline(&buffer, &capacity, in) > 0) {
+        std::istringstream line(buffer);
+        std::string kind, id, move;
+        line >> kind >> id;
+        if (kind == "error") {
+            errors++;
+            std::cerr << buffer;
+            continue;
+        }
+        if (kind == "bye") {
+            finished++;
+            continue;
+        }
+        if (kind != "bestmove") {
+            continue;
+        }
+        line >> move;
+        ClientSession& session = sessions[atoi(id.c_str() + 1)];
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - session.sent).count());
+        if (move == "none" || ++session.plies >= maxPlies) {
+            send_text(fd, "quit " + id + "\n");
+            continue;
+        }
+        session.sent = Clock::now();
+        send_text(fd, "move " + id + " " + move + "\ngo " + id + go);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << sessionCount << " sessions, " << latencies.size() << " coups en " << seconds << " s ("
+              << latencies.size() / seconds << " coups/s), " << errors << " erreurs" << std::endl;
+    std::cout << "Latence go vue du client : p50 " << percentile(latencies, 50) << " ms, p90 "
+              << percentile(latencies, 90) << " ms, p99 " << percentile(latencies, 99) << " ms, max "
+              << percentile(latencies, 100) << " ms" << std::endl;
+
+    // Mesures du serveur
+    send_text(fd, "stats\n");
+    while (getline(&buffer, &capacity, in) > 0 && strncmp(buffer, "stats end", 9) != 0) {
+        std::cout << "serveur : " << buffer;
+    }
+    if (shutdown) {
+        send_text(fd, "shutdown\n");
+    }
+    free(buffer);
+    fclose(in);
+    close(fd);
+    return errors == 0 ? 0 : 1;
+}
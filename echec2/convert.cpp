@@ -0,0 +1,86 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include "engine/archive.h"
+#include "engine/game.h"
+
+// Conversion des anciennes sauvegardes vers le format binaire d'archive.
+// Usage : chess_convert ARCHIVE SAUVEGARDE...   ajoute chaque sauvegarde à l'archive
+//         chess_convert --list ARCHIVE          affiche le contenu d'une archive
+//
+// Deux formats sont reconnus : le texte de save_game (chess2) et le fichier brut de
+// l'ancien chess.c (voir load_legacy_save).
+
+static int list_archive(const char* filename) {
+    ArchiveReader reader;
+    if (!reader.open(filename)) {
+        std::cerr << "Archive illisible : " << filename << std::endl;
+        return 1;
+    }
+    const char* results[] = {"?", "1-0", "0-1", "1/2"};
+    auto start = std::chrono::steady_clock::now();
+    uint64_t games = 0, moves = 0;
+    ArchiveGame game;
+    while (reader.next(game)) {
+        Position pos;
+        uint32_t ply;
+        if (!unpack_position(game.position, &pos, &ply)) {
+            std::cerr << "Position invalide dans l'enregistrement " << games << std::endl;
+            return 1;
+        }
+        std::cout << position_to_text(&pos) << " " << results[game.result] << " demi-coup " << ply;
+        for (uint32_t i = 0; i < game.moveCount; i++) {
+            std::cout << " " << move_to_text(game.move(i));
+        }
+        std::cout << std::endl;
+        games++;
+        moves += game.moveCount;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << games << " enregistrements, " << moves << " coups, " << reader.size() << " octets, "
+              << seconds * 1000 << " ms" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    init_zobrist();
+
+    if (argc == 3 && strcmp(argv[1], "--list") == 0) {
+        return list_archive(argv[2]);
+    }
+    if (argc < 3) {
+        std::cerr << "Usage : chess_convert ARCHIVE SAUVEGARDE... | chess_convert --list ARCHIVE" << std::endl;
+        return 2;
+    }
+
+    ArchiveWriter writer;
+    if (!writer.open(argv[1])) {
+        std::cerr << "Impossible d'ouvrir l'archive " << argv[1] << std::endl;
+        return 1;
+    }
+    int converted = 0;
+    for (int i = 2; i < argc; i++) {
+        std::ifstream file(argv[i], std::ios::binary);
+        std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        Game game;
+        const char* format = "chess.c";
+        if (!load_legacy_save(&game, bytes.data(), bytes.size())) {
+            format = "chess2";
+            if (!load_game(&game, argv[i])) {
+                std::cerr << argv[i] << " : format non reconnu" << std::endl;
+                continue;
+            }
+        }
+        if (!writer.write_position(&game.pos)) {
+            std::cerr << argv[i] << " : écriture impossible" << std::endl;
+            return 1;
+        }
+        std::cout << argv[i] << " (" << format << ") : " << position_to_text(&game.pos) << std::endl;
+        converted++;
+    }
+    std::cout << converted << " sauvegarde(s) ajoutée(s) à " << argv[1] << std::endl;
+    return converted == argc - 2 ? 0 : 1;
+}
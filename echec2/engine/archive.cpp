@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>     // Pour open
+#include <sys/mman.h>  // Pour mmap
+#include <sys/stat.h>
+#include <unistd.h>
+#include "archive.h"
+
+static const char ARCHIVE_MAGIC[8] = {'Q', 'N', 'R', 'B', 'A', 'R', 'C', '1'};
+
+static void write_le(uint8_t* out, uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; b++) {
+        out[b] = static_cast<uint8_t>(value >> (8 * b));
+    }
+}
+
+static uint64_t read_le(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int b = 0; b < bytes; b++) {
+        value |= static_cast<uint64_t>(in[b]) << (8 * b);
+    }
+    return value;
+}
+
+bool pack_position(const Position* pos, uint32_t ply, uint8_t* out) {
+    Bitboard occupied = pos->occupied[PLAYER1] | pos->occupied[PLAYER2];
+    if (popcount(occupied) > 32) {
+        return false;
+    }
+    memset(out, 0, PACKED_POSITION_SIZE);
+    write_le(out, occupied, 8);
+    int n = 0;
+    for (Bitboard b = occupied; b; n++) {
+        int square = pop_lsb(b);
+        out[8 + n / 2] |= pos->squares[square] << (4 * (n & 1));
+    }
+    out[24] = static_cast<uint8_t>(pos->sideToMove);
+    write_le(out + 26, pos->state.pliesSinceCapture, 2);
+    write_le(out + 28, ply, 4);
+    return true;
+}
+
+bool unpack_position(const uint8_t* bytes, Position* pos, uint32_t* ply) {
+    clear_position(pos);
+    Bitboard occupied = read_le(bytes, 8);
+    if (popcount(occupied) > 32 || bytes[24] > PLAYER2) {
+        return false;
+    }
+    int n = 0;
+    for (Bitboard b = occupied; b; n++) {
+        int square = pop_lsb(b);
+        uint8_t code = (bytes[8 + n / 2] >> (4 * (n & 1))) & 15;
+        PieceType type = code_type(code);
+        Player player = code_player(code);
+        if (type == EMPTY || type > BISHOP || pos->counts[player][EMPTY] >= MAX_PIECES) {
+            return false;
+        }
+        put_piece(pos, square, type, player);
+    }
+    set_side_to_move(pos, static_cast<Player>(bytes[24]));
+    pos->state.pliesSinceCapture = static_cast<uint16_t>(read_le(bytes + 26, 2));
+    if (ply != nullptr) {
+        *ply = static_cast<uint32_t>(read_le(bytes + 28, 4));
+    }
+    return true;
+}
+
+bool ArchiveWriter::open(const char* filename) {
+    close();
+    file = fopen(filename, "a+b"); // Les écritures vont toujours à la fin
+    if (file == nullptr) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) > 0) {
+        // Archive existante : n'ajouter qu'à un fichier du même format
+        uint8_t header[ARCHIVE_HEADER_SIZE];
+        fseek(file, 0, SEEK_SET);
+        if (fread(header, sizeof(header), 1, file) != 1 || memcmp(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0
+            || read_le(header + 8, 4) != ARCHIVE_VERSION) {
+            close();
+            return false;
+        }
+        // Un enregistrement tronqué (arrêt pendant une écriture) arrêterait la lecture de
+        // tout ce qui le suit : le fichier est ramené à la fin du dernier enregistrement complet
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        long end = ARCHIVE_HEADER_SIZE;
+        uint8_t record[ARCHIVE_RECORD_HEADER_SIZE];
+        while (fseek(file, end, SEEK_SET) == 0 && fread(record, sizeof(record), 1, file) == 1) {
+            long recordSize = ARCHIVE_RECORD_HEADER_SIZE + PACKED_POSITION_SIZE + 2 * static_cast<long>(read_le(record + 4, 4));
+            if (record[0] > RESULT_DRAW || size - end < recordSize) {
+                break;
+            }
+            end += recordSize;
+        }
+        // Repositionner le flux entre la lecture et la première écriture
+        fflush(file);
+        if ((end < size && ftruncate(fileno(file), end) != 0) || fseek(file, 0, SEEK_END) != 0) {
+            close();
+            return false;
+        }
+    } else {
+        uint8_t header[ARCHIVE_HEADER_SIZE] = {};
+        memcpy(header, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+        write_le(header + 8, ARCHIVE_VERSION, 4);
+        if (fwrite(header, sizeof(header), 1, file) != 1) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ArchiveWriter::close() {
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool ArchiveWriter::write_position(const Position* pos, uint32_t ply) {
+    uint8_t record[ARCHIVE_RECORD_HEADER_SIZE + PACKED_POSITION_SIZE] = {};
+    if (!pack_position(pos, ply, record + ARCHIVE_RECORD_HEADER_SIZE)) {
+        return false;
+    }
+    return fwrite(record, sizeof(record), 1, file) == 1;
+}
+
+bool ArchiveWriter::write_game(const Position* start, const Move* moves, uint32_t moveCount, ArchiveResult result) {
+    uint8_t record[ARCHIVE_RECORD_HEADER_SIZE + PACKED_POSITION_SIZE] = {};
+    record[0] = static_cast<uint8_t>(result);
+    write_le(record + 4, moveCount, 4);
+    if (!pack_position(start, 0, record + ARCHIVE_RECORD_HEADER_SIZE)
+        || fwrite(record, sizeof(record), 1, file) != 1) {
+        return false;
+    }
+    uint8_t buffer[512];
+    for (uint32_t i = 0; i < moveCount; i += sizeof(buffer) / 2) {
+        uint32_t count = std::min<uint32_t>(moveCount - i, sizeof(buffer) / 2);
+        for (uint32_t k = 0; k < count; k++) {
+            write_le(buffer + 2 * k, moves[i + k], 2);
+        }
+        if (fwrite(buffer, 2, count, file) != count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ArchiveReader::open(const char* filename) {
+    close();
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < ARCHIVE_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(mapping);
+    if (memcmp(bytes, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || read_le(bytes + 8, 4) != ARCHIVE_VERSION) {
+        munmap(mapping, size);
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    data = bytes;
+    length = size;
+    cursor = ARCHIVE_HEADER_SIZE;
+    return true;
+}
+
+void ArchiveReader::close() {
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = 0;
+    }
+}
+
+bool ArchiveReader::next(ArchiveGame& game) {
+    if (data == nullptr || length - cursor < ARCHIVE_RECORD_HEADER_SIZE + PACKED_POSITION_SIZE) {
+        return false;
+    }
+    const uint8_t* record = data + cursor;
+    uint64_t moveCount = read_le(record + 4, 4);
+    size_t recordSize = ARCHIVE_RECORD_HEADER_SIZE + PACKED_POSITION_SIZE + 2 * moveCount;
+    if (length - cursor < recordSize || record[0] > RESULT_DRAW) {
+        return false;
+    }
+    game.result = static_cast<ArchiveResult>(record[0]);
+    game.moveCount = static_cast<uint32_t>(moveCount);
+    game.position = record + ARCHIVE_RECORD_HEADER_SIZE;
+    game.moves = game.position + PACKED_POSITION_SIZE;
+    cursor += recordSize;
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef CHESS_ARCHIVE_H
+#define CHESS_ARCHIVE_H
+
+#include <cstdio>
+#include <cstddef>
+#include "position.h"
+
+// Format binaire stable (petit-boutiste, indépendant de la taille des enums) pour
+// stocker des millions de positions et de parties.
+//
+// Position compacte, 32 octets :
+//   0  occupation (u64), bit sq = case occupée
+//   8  16 octets de quartets, un par case occupée dans l'ordre croissant des cases :
+//      code mailbox (type | joueur << 3), quartet bas d'abord
+//   24 joueur au trait (u8)   25 réservé (u8)   26 demi-coups depuis la dernière prise (u16)
+//   28 numéro du demi-coup dans la partie (u32)
+//
+// Archive : en-tête de 16 octets (magic "QNRBARC1", version u32, réservé u32), puis
+// une suite d'enregistrements. Un enregistrement est une partie : 8 octets (résultat
+// u8, réservé u8 et u16, nombre de coups u32), la position de départ, puis les coups
+// sur 2 octets chacun dans l'encodage de Move. Une position seule est une partie
+// sans coup.
+
+#define PACKED_POSITION_SIZE 32
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_HEADER_SIZE 16
+#define ARCHIVE_RECORD_HEADER_SIZE 8
+
+// Résultat d'une partie archivée
+enum ArchiveResult { RESULT_UNKNOWN, RESULT_PLAYER1_WINS, RESULT_PLAYER2_WINS, RESULT_DRAW };
+
+// Écrire une position dans 32 octets ; false si elle a plus de 32 pièces
+bool pack_position(const Position* pos, uint32_t ply, uint8_t* out);
+
+// Lire une position compacte ; false si les octets ne décrivent pas une position valide
+bool unpack_position(const uint8_t* bytes, Position* pos, uint32_t* ply = nullptr);
+
+// Vue sur une partie de l'archive : pointe directement dans le fichier projeté
+struct ArchiveGame {
+    const uint8_t* position; // PACKED_POSITION_SIZE octets
+    const uint8_t* moves;    // moveCount coups de 2 octets
+    uint32_t moveCount;
+    ArchiveResult result;
+
+    Move move(uint32_t i) const { return static_cast<Move>(moves[2 * i] | (moves[2 * i + 1] << 8)); }
+};
+
+// Ajout de parties à la fin d'une archive (créée avec son en-tête si elle n'existe pas ;
+// un enregistrement tronqué en fin de fichier est retiré à l'ouverture)
+class ArchiveWriter {
+public:
+    ~ArchiveWriter() { close(); }
+
+    bool open(const char* filename);
+    void close();
+
+    bool write_position(const Position* pos, uint32_t ply = 0);
+    bool write_game(const Position* start, const Move* moves, uint32_t moveCount, ArchiveResult result);
+
+private:
+    FILE* file = nullptr;
+};
+
+// Lecture d'une archive projetée en mémoire : les parties sont parcourues sans copie
+class ArchiveReader {
+public:
+    ~ArchiveReader() { close(); }
+
+    bool open(const char* filename);
+    void close();
+
+    // Partie suivante ; false à la fin ou si l'enregistrement est tronqué
+    bool next(ArchiveGame& game);
+    void rewind() { cursor = ARCHIVE_HEADER_SIZE; }
+
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t cursor = 0;
+};
+
+#endif
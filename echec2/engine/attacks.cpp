@@ -0,0 +1,111 @@
+#include "attacks.h"
+
+Magic rookMagics[SQUARE_COUNT];
+Magic bishopMagics[SQUARE_COUNT];
+Bitboard knightAttacks[SQUARE_COUNT];
+bool usePext = false;
+
+static Bitboard rookTable[0x19000];  // Somme des 2^bits des masques de tour
+static Bitboard bishopTable[0x1480]; // Somme des 2^bits des masques de fou
+
+// Attaques calculées rayon par rayon, utilisées seulement pour remplir les tables
+static Bitboard sliding_attacks(const int directions[4][2], int square, Bitboard occupied) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        int x = square_x(square) + directions[d][0];
+        int y = square_y(square) + directions[d][1];
+        while (x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE) {
+            attacks |= square_bb(square_of(x, y));
+            if (occupied & square_bb(square_of(x, y))) {
+                break; // Le rayon s'arrête sur le premier bloqueur
+            }
+            x += directions[d][0];
+            y += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+static void init_magics(const int directions[4][2], Magic magics[], Bitboard table[]) {
+    Bitboard occupancy[4096], reference[4096];
+    int epoch[4096] = {0};
+    int attempt = 0;
+    Prng rng(728);
+    Bitboard edges = 0;
+    Bitboard* next = table;
+
+    for (int square = 0; square < SQUARE_COUNT; square++) {
+        // Les bords ne bloquent rien de plus : on les retire du masque, sauf sur la ligne/colonne de la pièce
+        Bitboard rankEdges = 0xFFULL | (0xFFULL << 56);
+        Bitboard fileEdges = 0x0101010101010101ULL | (0x0101010101010101ULL << 7);
+        edges = (rankEdges & ~(0xFFULL << (8 * square_y(square))))
+              | (fileEdges & ~(0x0101010101010101ULL << square_x(square)));
+
+        Magic& m = magics[square];
+        m.mask = sliding_attacks(directions, square, 0) & ~edges;
+        m.shift = 64 - popcount(m.mask);
+        m.attacks = next;
+
+        // Énumérer tous les sous-ensembles du masque (carry-rippler)
+        int size = 0;
+        Bitboard b = 0;
+        do {
+            occupancy[size] = b;
+            reference[size] = sliding_attacks(directions, square, b);
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+        next += size;
+
+#ifdef HAS_PEXT_PATH
+        if (usePext) {
+            for (int i = 0; i < size; i++) {
+                m.attacks[pext(occupancy[i], m.mask)] = reference[i];
+            }
+            continue;
+        }
+#endif
+
+        // Chercher un multiplicateur sans collision destructive
+        for (int i = 0; i < size; ) {
+            m.magic = 0;
+            while (popcount((m.mask * m.magic) >> 56) < 6) {
+                m.magic = rng.sparse();
+            }
+            ++attempt;
+            for (i = 0; i < size; i++) {
+                unsigned index = magic_index(m, occupancy[i]);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    m.attacks[index] = reference[i];
+                } else if (m.attacks[index] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void init_attacks() {
+    static const int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    static const int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    static const int knightJumps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+
+#ifdef HAS_PEXT_PATH
+    usePext = __builtin_cpu_supports("bmi2");
+#endif
+
+    init_magics(rookDirections, rookMagics, rookTable);
+    init_magics(bishopDirections, bishopMagics, bishopTable);
+
+    for (int square = 0; square < SQUARE_COUNT; square++) {
+        knightAttacks[square] = 0;
+        for (const auto& jump : knightJumps) {
+            int x = square_x(square) + jump[0];
+            int y = square_y(square) + jump[1];
+            if (x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE) {
+                knightAttacks[square] |= square_bb(square_of(x, y));
+            }
+        }
+    }
+}
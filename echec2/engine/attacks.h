@@ -0,0 +1,138 @@
+#ifndef CHESS_ATTACKS_H
+#define CHESS_ATTACKS_H
+
+#include "bitboard.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define HAS_PEXT_PATH 1 // PEXT (BMI2) n'existe que sur x86-64
+#endif
+
+// Tables d'attaque pour une case de pièce glissante : l'indice dans la table
+// vient soit d'une multiplication magique, soit de PEXT quand le CPU le permet
+struct Magic {
+    Bitboard mask;     // Cases pouvant bloquer la pièce (bords exclus)
+    Bitboard magic;    // Multiplicateur magique
+    Bitboard* attacks; // Tranche de la table réservée à cette case
+    int shift;         // 64 - nombre de bits du masque
+};
+
+extern Magic rookMagics[SQUARE_COUNT];
+extern Magic bishopMagics[SQUARE_COUNT];
+extern Bitboard knightAttacks[SQUARE_COUNT];
+extern bool usePext;
+
+#ifdef HAS_PEXT_PATH
+// Écrit en assembleur pour rester inlinable sans compiler tout le fichier en BMI2
+inline uint64_t pext(uint64_t source, uint64_t mask) {
+    uint64_t result;
+    __asm__("pext %2, %1, %0" : "=r"(result) : "r"(source), "r"(mask));
+    return result;
+}
+#endif
+
+inline unsigned magic_index(const Magic& m, Bitboard occupied) {
+#ifdef HAS_PEXT_PATH
+    if (usePext) {
+        return static_cast<unsigned>(pext(occupied, m.mask));
+    }
+#endif
+    return static_cast<unsigned>(((occupied & m.mask) * m.magic) >> m.shift);
+}
+
+inline Bitboard rook_attacks(int square, Bitboard occupied) {
+    const Magic& m = rookMagics[square];
+    return m.attacks[magic_index(m, occupied)];
+}
+
+inline Bitboard bishop_attacks(int square, Bitboard occupied) {
+    const Magic& m = bishopMagics[square];
+    return m.attacks[magic_index(m, occupied)];
+}
+
+// Cases attaquées par une pièce posée sur square, compte tenu des bloqueurs
+inline Bitboard attacks_from(PieceType type, int square, Bitboard occupied) {
+    switch (type) {
+        case QUEEN:  return rook_attacks(square, occupied) | bishop_attacks(square, occupied);
+        case KNIGHT: return knightAttacks[square];
+        case ROOK:   return rook_attacks(square, occupied);
+        case BISHOP: return bishop_attacks(square, occupied);
+        default:     return 0;
+    }
+}
+
+// Initialiser toutes les tables d'attaque (à appeler une fois au démarrage)
+void init_attacks();
+
+// Directions des rayons sur les plateaux plus grands : les quatre premières font croître
+// l'indice de case (y * N + x), les quatre dernières le font décroître.
+// Tour : 0, 1, 4, 5 ; fou : 2, 3, 6, 7.
+constexpr int RayDirections[8][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}, {-1, 0}, {0, -1}, {-1, -1}, {1, -1}};
+
+// Tables d'attaque d'un plateau N x N autre que 8x8, calculées à la compilation
+template <int N>
+struct RayTables {
+    typedef BoardBitboard<N> B;
+    B knight[N * N];
+    B rays[8][N * N + 1]; // Indice N * N : case sentinelle, rayon vide
+
+    constexpr RayTables() : knight(), rays() {
+        const int jumps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        for (int square = 0; square < N * N; square++) {
+            int x = square % N, y = square / N;
+            for (const auto& jump : jumps) {
+                int tx = x + jump[0], ty = y + jump[1];
+                if (tx >= 0 && tx < N && ty >= 0 && ty < N) {
+                    knight[square] |= square_bit<N>(ty * N + tx);
+                }
+            }
+            for (int d = 0; d < 8; d++) {
+                for (int tx = x + RayDirections[d][0], ty = y + RayDirections[d][1];
+                     tx >= 0 && tx < N && ty >= 0 && ty < N; tx += RayDirections[d][0], ty += RayDirections[d][1]) {
+                    rays[d][square] |= square_bit<N>(ty * N + tx);
+                }
+            }
+        }
+    }
+};
+template <int N>
+inline constexpr RayTables<N> Rays{};
+
+// Cases vues le long du rayon D jusqu'au premier bloqueur compris. Le bloqueur est le
+// bit le plus proche dans le sens du rayon ; la sentinelle (case N * N pour les rayons
+// croissants, case 0 pour les décroissants) tient lieu de bloqueur quand il n'y en a pas,
+// et son rayon est vide : aucun test sur l'absence de bloqueur.
+template <int N, int D>
+inline BoardBitboard<N> ray_attacks(int square, const BoardBitboard<N>& occupied) {
+    const BoardBitboard<N>* rays = Rays<N>.rays[D];
+    BoardBitboard<N> ray = rays[square];
+    int blocker = D < 4 ? lsb((ray & occupied) | square_bit<N>(N * N)) : msb((ray & occupied) | square_bit<N>(0));
+    return ray ^ rays[blocker];
+}
+
+// Cases attaquées sur un plateau N x N : tables magiques en 8x8, rayons au-delà
+template <int N>
+inline BoardBitboard<N> board_attacks(PieceType type, int square, const BoardBitboard<N>& occupied) {
+    if constexpr (N == BOARD_SIZE) {
+        return attacks_from(type, square, occupied);
+    } else {
+        switch (type) {
+            case QUEEN:
+                return ray_attacks<N, 0>(square, occupied) | ray_attacks<N, 1>(square, occupied)
+                     | ray_attacks<N, 4>(square, occupied) | ray_attacks<N, 5>(square, occupied)
+                     | ray_attacks<N, 2>(square, occupied) | ray_attacks<N, 3>(square, occupied)
+                     | ray_attacks<N, 6>(square, occupied) | ray_attacks<N, 7>(square, occupied);
+            case KNIGHT:
+                return Rays<N>.knight[square];
+            case ROOK:
+                return ray_attacks<N, 0>(square, occupied) | ray_attacks<N, 1>(square, occupied)
+                     | ray_attacks<N, 4>(square, occupied) | ray_attacks<N, 5>(square, occupied);
+            case BISHOP:
+                return ray_attacks<N, 2>(square, occupied) | ray_attacks<N, 3>(square, occupied)
+                     | ray_attacks<N, 6>(square, occupied) | ray_attacks<N, 7>(square, occupied);
+            default:
+                return BoardBitboard<N>();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef CHESS_BITBOARD_H
+#define CHESS_BITBOARD_H
+
+#include <type_traits>
+#include "types.h"
+
+// Bitboards des plateaux N x N. Le type suit le nombre de cases : Bitboard (64 bits)
+// jusqu'au 8x8, 128 bits jusqu'au 11x11, plusieurs mots de 64 bits au-delà. Chaque
+// sorte a ses propres lsb, msb, pop_lsb et popcount, si bien que le code écrit pour
+// un plateau N x N se compile sans test de taille à l'exécution.
+
+typedef unsigned __int128 Bitboard128;
+
+// Bitboard de W mots de 64 bits : la case c est au bit c % 64 du mot c / 64
+template <int W>
+struct WideBitboard {
+    uint64_t words[W];
+
+    constexpr WideBitboard() : words() {}
+
+    constexpr WideBitboard& operator|=(const WideBitboard& o) {
+        for (int i = 0; i < W; i++) words[i] |= o.words[i];
+        return *this;
+    }
+    constexpr WideBitboard& operator&=(const WideBitboard& o) {
+        for (int i = 0; i < W; i++) words[i] &= o.words[i];
+        return *this;
+    }
+    constexpr WideBitboard& operator^=(const WideBitboard& o) {
+        for (int i = 0; i < W; i++) words[i] ^= o.words[i];
+        return *this;
+    }
+    constexpr WideBitboard operator|(const WideBitboard& o) const { WideBitboard r = *this; return r |= o; }
+    constexpr WideBitboard operator&(const WideBitboard& o) const { WideBitboard r = *this; return r &= o; }
+    constexpr WideBitboard operator^(const WideBitboard& o) const { WideBitboard r = *this; return r ^= o; }
+    constexpr WideBitboard operator~() const {
+        WideBitboard r;
+        for (int i = 0; i < W; i++) r.words[i] = ~words[i];
+        return r;
+    }
+    constexpr bool operator==(const WideBitboard& o) const {
+        for (int i = 0; i < W; i++) {
+            if (words[i] != o.words[i]) return false;
+        }
+        return true;
+    }
+    constexpr bool operator!=(const WideBitboard& o) const { return !(*this == o); }
+    constexpr explicit operator bool() const {
+        uint64_t all = 0;
+        for (int i = 0; i < W; i++) all |= words[i];
+        return all != 0;
+    }
+};
+
+inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+
+// Les versions 128 bits ne sont retenues que pour ce type exact : un entier ordinaire
+// passé à popcount reste sur la version 64 bits de types.h
+template <typename B>
+using IfBitboard128 = typename std::enable_if<std::is_same<B, Bitboard128>::value, int>::type;
+
+template <typename B, IfBitboard128<B> = 0>
+inline int lsb(B b) {
+    uint64_t low = static_cast<uint64_t>(b);
+    return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(b >> 64));
+}
+template <typename B, IfBitboard128<B> = 0>
+inline int msb(B b) {
+    uint64_t high = static_cast<uint64_t>(b >> 64);
+    return high ? 127 - __builtin_clzll(high) : 63 - __builtin_clzll(static_cast<uint64_t>(b));
+}
+template <typename B, IfBitboard128<B> = 0>
+inline int pop_lsb(B& b) { int square = lsb(b); b &= b - 1; return square; }
+template <typename B, IfBitboard128<B> = 0>
+inline int popcount(B b) {
+    return __builtin_popcountll(static_cast<uint64_t>(b)) + __builtin_popcountll(static_cast<uint64_t>(b >> 64));
+}
+
+template <int W>
+inline int lsb(const WideBitboard<W>& b) {
+    for (int i = 0; i < W - 1; i++) {
+        if (b.words[i]) return 64 * i + __builtin_ctzll(b.words[i]);
+    }
+    return 64 * (W - 1) + __builtin_ctzll(b.words[W - 1]);
+}
+template <int W>
+inline int msb(const WideBitboard<W>& b) {
+    for (int i = W - 1; i > 0; i--) {
+        if (b.words[i]) return 64 * i + 63 - __builtin_clzll(b.words[i]);
+    }
+    return 63 - __builtin_clzll(b.words[0]);
+}
+template <int W>
+inline int pop_lsb(WideBitboard<W>& b) {
+    for (int i = 0; i < W - 1; i++) {
+        if (b.words[i]) {
+            int square = 64 * i + __builtin_ctzll(b.words[i]);
+            b.words[i] &= b.words[i] - 1;
+            return square;
+        }
+    }
+    int square = 64 * (W - 1) + __builtin_ctzll(b.words[W - 1]);
+    b.words[W - 1] &= b.words[W - 1] - 1;
+    return square;
+}
+template <int W>
+inline int popcount(const WideBitboard<W>& b) {
+    int n = 0;
+    for (int i = 0; i < W; i++) n += __builtin_popcountll(b.words[i]);
+    return n;
+}
+
+// Bitboard d'un plateau N x N. Au-delà de 8x8, il reste toujours au moins un bit libre
+// après la dernière case : il sert de sentinelle aux rayons (voir attacks.h).
+template <int N>
+using BoardBitboard = typename std::conditional<N * N <= 64, Bitboard,
+                      typename std::conditional<N * N < 128, Bitboard128, WideBitboard<N * N / 64 + 1>>::type>::type;
+
+// Bit d'une case
+template <int N>
+constexpr BoardBitboard<N> square_bit(int square) {
+    if constexpr (N * N < 128) {
+        return BoardBitboard<N>(1) << square;
+    } else {
+        BoardBitboard<N> b;
+        b.words[square / 64] = uint64_t(1) << (square % 64);
+        return b;
+    }
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <fcntl.h>     // Pour open
+#include <sys/mman.h>  // Pour mmap
+#include <sys/stat.h>
+#include <unistd.h>
+#include "book.h"
+#include "movegen.h"
+
+static const char BOOK_MAGIC[8] = {'Q', 'N', 'R', 'B', 'B', 'O', 'K', '1'};
+
+// Livre chargé : les entrées pointent dans la projection du fichier
+static const uint8_t* bookEntries = nullptr;
+static size_t bookCount = 0;
+static void* bookMapping = nullptr;
+static size_t bookMappingSize = 0;
+
+static void write_le(uint8_t* out, uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; b++) {
+        out[b] = static_cast<uint8_t>(value >> (8 * b));
+    }
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint64_t read_u64(const uint8_t* p) {
+    return read_u32(p) | (static_cast<uint64_t>(read_u32(p + 4)) << 32);
+}
+
+bool book_write(const char* filename, std::vector<BookEntry>& entries) {
+    std::sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.move < b.move;
+    });
+    // Doublons fusionnés, poids saturés à 16 bits
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (kept > 0 && entries[kept - 1].key == entries[i].key && entries[kept - 1].move == entries[i].move) {
+            BookEntry& merged = entries[kept - 1];
+            merged.weight = static_cast<uint16_t>(std::min(65535, merged.weight + entries[i].weight));
+            merged.samples += entries[i].samples;
+        } else {
+            entries[kept++] = entries[i];
+        }
+    }
+    entries.resize(kept);
+    std::stable_sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t header[BOOK_HEADER_SIZE] = {};
+    memcpy(header, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    write_le(header + 8, BOOK_VERSION, 4);
+    write_le(header + 12, entries.size(), 4);
+    bool ok = fwrite(header, BOOK_HEADER_SIZE, 1, file) == 1;
+    for (const BookEntry& entry : entries) {
+        uint8_t bytes[BOOK_ENTRY_SIZE] = {};
+        write_le(bytes, entry.key, 8);
+        write_le(bytes + 8, entry.move, 2);
+        write_le(bytes + 10, entry.weight, 2);
+        write_le(bytes + 12, entry.samples, 4);
+        ok = ok && fwrite(bytes, BOOK_ENTRY_SIZE, 1, file) == 1;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+bool book_init(const char* filename) {
+    book_free();
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < BOOK_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // Seul l'en-tête est vérifié : les entrées sont lues telles quelles à la consultation
+    const uint8_t* header = static_cast<const uint8_t*>(mapping);
+    size_t count = read_u32(header + 12);
+    if (memcmp(header, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || read_u32(header + 8) != BOOK_VERSION
+        || size != BOOK_HEADER_SIZE + count * BOOK_ENTRY_SIZE) {
+        munmap(mapping, size);
+        return false;
+    }
+    bookEntries = header + BOOK_HEADER_SIZE;
+    bookCount = count;
+    bookMapping = mapping;
+    bookMappingSize = size;
+    return true;
+}
+
+void book_free() {
+    if (bookMapping != nullptr) {
+        munmap(bookMapping, bookMappingSize);
+    }
+    bookEntries = nullptr;
+    bookCount = 0;
+    bookMapping = nullptr;
+    bookMappingSize = 0;
+}
+
+size_t book_entries() {
+    return bookCount;
+}
+
+size_t book_size() {
+    return bookMappingSize;
+}
+
+int book_probe(uint64_t key, BookEntry* entries, int max) {
+    // Première entrée de clé >= key
+    size_t low = 0, high = bookCount;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (read_u64(bookEntries + middle * BOOK_ENTRY_SIZE) < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    int found = 0;
+    for (size_t i = low; i < bookCount && found < max; i++) {
+        const uint8_t* p = bookEntries + i * BOOK_ENTRY_SIZE;
+        if (read_u64(p) != key) {
+            break;
+        }
+        entries[found].key = key;
+        entries[found].move = static_cast<Move>(p[8] | (p[9] << 8));
+        entries[found].weight = static_cast<uint16_t>(p[10] | (p[11] << 8));
+        entries[found].samples = read_u32(p + 12);
+        found++;
+    }
+    return found;
+}
+
+bool book_move(const Position& pos, Move& move) {
+    if (bookCount == 0) {
+        return false;
+    }
+    BookEntry entries[BOOK_MAX_MOVES];
+    int count = book_probe(pos.state.key, entries, BOOK_MAX_MOVES);
+    // Une collision de clés donnerait des coups étrangers à la position : écartés
+    uint32_t total = 0;
+    int valid = 0;
+    for (int i = 0; i < count; i++) {
+        if (entries[i].weight > 0 && is_pseudo_legal(pos, entries[i].move)) {
+            entries[valid++] = entries[i];
+            total += entries[i].weight;
+        }
+    }
+    if (total == 0) {
+        return false;
+    }
+    static thread_local Prng rng((static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+                                  ^ std::hash<std::thread::id>()(std::this_thread::get_id())) | 1);
+    uint32_t pick = static_cast<uint32_t>(rng.next() % total);
+    for (int i = 0; i < valid; i++) {
+        if (pick < entries[i].weight) {
+            move = entries[i].move;
+            return true;
+        }
+        pick -= entries[i].weight;
+    }
+    return false;
+}
@@ -0,0 +1,49 @@
+#ifndef CHESS_BOOK_H
+#define CHESS_BOOK_H
+
+#include <cstddef>
+#include <vector>
+#include "position.h"
+
+// Livre d'ouverture précalculé (produit par chess_book). Le fichier est projeté par
+// mmap et lu tel quel : aucune analyse au chargement, chaque consultation est une
+// recherche dichotomique sur la clé Zobrist de la position.
+//
+// Fichier : en-tête de 16 octets en petit-boutiste, puis les entrées de 16 octets
+// triées par clé croissante (et par poids décroissant pour une même clé).
+//   en-tête : 0 magic "QNRBBOK1"   8 version (u32)   12 nombre d'entrées (u32)
+//   entrée  : 0 clé (u64)   8 coup (u16, encodage de Move)   10 poids (u16)
+//             12 parties ou recherches à l'origine de l'entrée (u32)
+
+#define BOOK_VERSION 1
+#define BOOK_HEADER_SIZE 16
+#define BOOK_ENTRY_SIZE 16
+#define BOOK_MAX_MOVES 64 // Coups gardés au plus pour une position
+
+struct BookEntry {
+    uint64_t key;
+    Move move;
+    uint16_t weight;  // Fréquence relative du coup parmi ceux de la position
+    uint32_t samples;
+};
+
+// Trier les entrées, fusionner les doublons (même clé, même coup) et écrire le
+// livre ; false en cas d'erreur
+bool book_write(const char* filename, std::vector<BookEntry>& entries);
+
+// Projeter un livre (le précédent est libéré) ; false si absent ou invalide
+bool book_init(const char* filename);
+void book_free();
+
+// Entrées et octets du livre chargé (0 sans livre)
+size_t book_entries();
+size_t book_size();
+
+// Coups du livre pour une clé, poids décroissants ; retourne leur nombre (au plus max)
+int book_probe(uint64_t key, BookEntry* entries, int max);
+
+// Coup tiré au hasard selon les poids parmi ceux du livre valides dans la position ;
+// false si la position n'y est pas
+bool book_move(const Position& pos, Move& move);
+
+#endif
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "chess_api.h"
+#include "attacks.h"
+#include "game.h"
+#include "journal.h"
+#include "movegen.h"
+#include "search.h"
+#include "tt.h"
+
+static_assert(sizeof(chess_board) == 68, "chess_board fait partie de l'interface binaire");
+static_assert(sizeof(chess_search_result) == 24, "chess_search_result fait partie de l'interface binaire");
+
+struct chess_game {
+    Game game;
+    Journal journal;
+};
+
+// Construire une position depuis la forme échangée ; false si elle est invalide
+static bool board_to_position(const chess_board* board, Position* pos) {
+    if (board->side_to_move > PLAYER2) {
+        return false;
+    }
+    clear_position(pos);
+    for (int square = 0; square < SQUARE_COUNT; square++) {
+        uint8_t code = board->squares[square];
+        if (code == 0) {
+            continue;
+        }
+        PieceType type = code_type(code);
+        Player player = code_player(code);
+        if (type < QUEEN || type > BISHOP || (code >> 3) > PLAYER2 || pos->counts[player][EMPTY] >= MAX_PIECES) {
+            return false;
+        }
+        put_piece(pos, square, type, player);
+    }
+    set_side_to_move(pos, static_cast<Player>(board->side_to_move));
+    pos->state.pliesSinceCapture = board->plies_since_capture;
+    return true;
+}
+
+static void position_to_board(const Position& pos, chess_board* board) {
+    memcpy(board->squares, pos.squares, SQUARE_COUNT);
+    board->side_to_move = static_cast<uint8_t>(pos.sideToMove);
+    board->reserved = 0;
+    board->plies_since_capture = pos.state.pliesSinceCapture;
+}
+
+static int position_status(const Position& pos) {
+    if (pos.counts[PLAYER1][EMPTY] == 0) {
+        return CHESS_PLAYER2_WINS;
+    }
+    if (pos.counts[PLAYER2][EMPTY] == 0) {
+        return CHESS_PLAYER1_WINS;
+    }
+    MoveList list;
+    generate_moves(pos, list);
+    return list.size == 0 ? CHESS_DRAW : CHESS_ONGOING;
+}
+
+// Répartir count tâches sur des threads qui prennent chacun la suivante
+template <typename F>
+static void parallel_for(size_t count, int threads, F fn) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threads = static_cast<int>(std::min<size_t>(threads, count));
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                fn(i);
+            }
+        });
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+extern "C" {
+
+int chess_api_version(void) {
+    return CHESS_API_VERSION;
+}
+
+void chess_init(size_t hash_megabytes) {
+    static std::once_flag once;
+    std::call_once(once, [hash_megabytes]() {
+        init_attacks();
+        init_zobrist();
+        TT.resize(std::max<size_t>(1, hash_megabytes));
+    });
+}
+
+void chess_start_board(chess_board* board) {
+    Position pos;
+    initialize_board(&pos);
+    position_to_board(pos, board);
+}
+
+int chess_board_from_text(chess_board* board, const char* text) {
+    Position pos;
+    if (!position_from_text(&pos, text)) {
+        return 0;
+    }
+    position_to_board(pos, board);
+    return 1;
+}
+
+int chess_board_to_text(const chess_board* board, char* text, size_t size) {
+    Position pos;
+    if (!board_to_position(board, &pos)) {
+        return 0;
+    }
+    std::string s = position_to_text(&pos);
+    if (s.size() >= size) {
+        return 0;
+    }
+    memcpy(text, s.c_str(), s.size() + 1);
+    return 1;
+}
+
+chess_move chess_find_move(const chess_board* board, int from_x, int from_y, int to_x, int to_y) {
+    Position pos;
+    if (!board_to_position(board, &pos) || !on_board(from_x, from_y)) {
+        return MOVE_NONE;
+    }
+    uint8_t code = pos.squares[square_of(from_x, from_y)];
+    if (code == 0 || code_player(code) != pos.sideToMove || !is_valid_move(&pos, from_x, from_y, to_x, to_y)) {
+        return MOVE_NONE;
+    }
+    int to = square_of(to_x, to_y);
+    return encode_move(square_of(from_x, from_y), to, code_type(pos.squares[to]));
+}
+
+int chess_play(chess_board* board, chess_move move) {
+    Position pos;
+    if (move == MOVE_NONE || !board_to_position(board, &pos) || !is_pseudo_legal(pos, move)) {
+        return 0;
+    }
+    apply_move(pos, move);
+    position_to_board(pos, board);
+    return 1;
+}
+
+int chess_status(const chess_board* board) {
+    Position pos;
+    return board_to_position(board, &pos) ? position_status(pos) : CHESS_INVALID;
+}
+
+size_t chess_generate_moves_batch(const chess_board* boards, size_t count,
+                                  chess_move* moves, size_t capacity, uint32_t* offsets) {
+    // Un seul passage : les coups sont écrits tant qu'il reste de la place, le total
+    // est compté jusqu'au bout pour dire à l'appelant quelle taille prévoir
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        offsets[i] = static_cast<uint32_t>(total);
+        Position pos;
+        if (!board_to_position(&boards[i], &pos)) {
+            continue;
+        }
+        MoveList list;
+        generate_moves(pos, list);
+        if (total + list.size <= capacity) {
+            memcpy(moves + total, list.moves, list.size * sizeof(Move));
+        }
+        total += list.size;
+    }
+    offsets[count] = static_cast<uint32_t>(total);
+    return total;
+}
+
+void chess_evaluate_batch(const chess_board* boards, size_t count, int32_t* scores) {
+    for (size_t i = 0; i < count; i++) {
+        Position pos;
+        scores[i] = board_to_position(&boards[i], &pos) ? evaluate(pos) : CHESS_INVALID_SCORE;
+    }
+}
+
+void chess_search_batch(const chess_board* boards, size_t count, int depth, uint64_t nodes,
+                        int threads, chess_search_result* results) {
+    SearchLimits limits;
+    limits.depth = std::max(1, std::min(depth, MAX_PLY - 1));
+    limits.nodes = nodes;
+    limits.threads = 1; // Le parallélisme se fait entre les positions du lot
+    parallel_for(count, threads, [&](size_t i) {
+        chess_search_result& out = results[i];
+        out = chess_search_result();
+        Position pos;
+        if (!board_to_position(&boards[i], &pos)) {
+            out.score = CHESS_INVALID_SCORE;
+            return;
+        }
+        SearchResult r = search(pos, limits);
+        out.best_move = r.bestMove;
+        out.score = r.score;
+        out.depth = r.depth;
+        out.nodes = r.nodes;
+    });
+}
+
+chess_game* chess_game_new(void) {
+    chess_game* game = new chess_game();
+    initialize_board(&game->game.pos);
+    return game;
+}
+
+void chess_game_free(chess_game* game) {
+    delete game;
+}
+
+void chess_game_board(const chess_game* game, chess_board* board) {
+    position_to_board(game->game.pos, board);
+}
+
+int chess_game_play(chess_game* game, int from_x, int from_y, int to_x, int to_y) {
+    return make_move(&game->game, from_x, from_y, to_x, to_y) ? 1 : 0;
+}
+
+int chess_game_status(const chess_game* game) {
+    int status = position_status(game->game.pos);
+    if (status == CHESS_ONGOING && isThreefoldRepetition(&game->game)) {
+        return CHESS_DRAW;
+    }
+    return status;
+}
+
+int chess_game_save(chess_game* game, const char* filename) {
+    if (!game->journal.is_open()) {
+        if (!game->journal.create(filename, game->game.pos)) {
+            return 0;
+        }
+        game->game.journal = &game->journal;
+    }
+    return game->journal.flush() ? 1 : 0;
+}
+
+int chess_game_load(chess_game* game, const char* filename) {
+    game->game.journal = nullptr;
+    game->journal.close();
+    if (game->journal.resume(filename, &game->game)) {
+        game->game.journal = &game->journal; // La partie continue dans le même journal
+        return 1;
+    }
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.is_open()) {
+        return 0;
+    }
+    if (load_legacy_save(&game->game, bytes.data(), bytes.size())) {
+        return 1;
+    }
+    return load_game(&game->game, filename) ? 1 : 0;
+}
+
+}
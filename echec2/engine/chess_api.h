@@ -0,0 +1,120 @@
+#ifndef CHESS_API_H
+#define CHESS_API_H
+
+// Interface C du moteur, commune à chess.c, à l'interface graphique et aux services
+// qui l'appellent depuis d'autres langages (bibliothèque partagée libchess_core).
+// Les appels par lots traitent un tableau de positions en un seul passage de la
+// frontière, pour que le coût d'un appel étranger ne compte plus par position.
+//
+// Les cases sont numérotées y * 8 + x ; une case contient 0 si elle est vide, sinon
+// type | (joueur << 3) avec les types 1 dame, 2 cavalier, 3 tour, 4 fou et les joueurs
+// 0 et 1. Un coup tient sur 16 bits : départ (bits 0-5), arrivée (bits 6-11) et type
+// de la pièce prise (bits 12-14).
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define CHESS_API __declspec(dllexport)
+#else
+#define CHESS_API __attribute__((visibility("default")))
+#endif
+
+#define CHESS_API_VERSION 1
+#define CHESS_MAX_MOVES 256
+#define CHESS_INVALID_SCORE INT32_MIN // Score rendu pour une position invalide
+
+// Position échangée à travers l'interface : 68 octets, sans pointeur
+typedef struct chess_board {
+    uint8_t squares[64];
+    uint8_t side_to_move;
+    uint8_t reserved;
+    uint16_t plies_since_capture;
+} chess_board;
+
+typedef uint16_t chess_move;
+
+typedef struct chess_search_result {
+    chess_move best_move; // 0 si la position est invalide ou sans coup
+    int16_t reserved;
+    int32_t score;        // Du point de vue du joueur au trait
+    int32_t depth;
+    uint64_t nodes;
+} chess_search_result;
+
+// État d'une partie
+enum {
+    CHESS_ONGOING = 0,
+    CHESS_PLAYER1_WINS = 1,
+    CHESS_PLAYER2_WINS = 2,
+    CHESS_DRAW = 3,
+    CHESS_INVALID = -1
+};
+
+CHESS_API int chess_api_version(void);
+
+// Préparer le moteur ; seul le premier appel compte (taille de la table de transposition en Mo)
+CHESS_API void chess_init(size_t hash_megabytes);
+
+CHESS_API void chess_start_board(chess_board* board);
+
+// Notation texte du moteur, celle de position_to_text ; 1 si réussi
+CHESS_API int chess_board_from_text(chess_board* board, const char* text);
+CHESS_API int chess_board_to_text(const chess_board* board, char* text, size_t size);
+
+// Coup de (fromX, fromY) vers (toX, toY) s'il est permis, 0 sinon
+CHESS_API chess_move chess_find_move(const chess_board* board, int from_x, int from_y, int to_x, int to_y);
+
+// Jouer un coup permis ; 1 si réussi
+CHESS_API int chess_play(chess_board* board, chess_move move);
+
+// Gagnant, nulle faute de coup, ou partie en cours
+CHESS_API int chess_status(const chess_board* board);
+
+// Coups de count positions. Les coups de la position i sont
+// moves[offsets[i]] .. moves[offsets[i + 1] - 1] (offsets a count + 1 éléments) ; une
+// position invalide n'a aucun coup. Rend le nombre total de coups, et offsets est
+// toujours rempli en entier. Si ce total dépasse capacity, seules les positions dont
+// tous les coups tiennent dans moves, avant la première qui déborde, y sont écrites :
+// l'appel est à refaire avec un tableau d'au moins le total rendu.
+CHESS_API size_t chess_generate_moves_batch(const chess_board* boards, size_t count,
+                                            chess_move* moves, size_t capacity, uint32_t* offsets);
+
+// Évaluation statique de count positions, du point de vue du joueur au trait
+CHESS_API void chess_evaluate_batch(const chess_board* boards, size_t count, int32_t* scores);
+
+// Recherche sur count positions, réparties sur threads threads (0 : tous les cœurs).
+// Chaque recherche s'arrête à depth, ou à nodes noeuds si nodes n'est pas nul.
+CHESS_API void chess_search_batch(const chess_board* boards, size_t count, int depth, uint64_t nodes,
+                                  int threads, chess_search_result* results);
+
+// Partie suivie : position, positions déjà jouées (répétitions) et journal de sauvegarde
+typedef struct chess_game chess_game;
+
+CHESS_API chess_game* chess_game_new(void);
+CHESS_API void chess_game_free(chess_game* game);
+CHESS_API void chess_game_board(const chess_game* game, chess_board* board);
+
+// Jouer un coup par ses coordonnées ; 1 si le coup est permis
+CHESS_API int chess_game_play(chess_game* game, int from_x, int from_y, int to_x, int to_y);
+
+// Comme chess_status, avec en plus la nulle par triple répétition
+CHESS_API int chess_game_status(const chess_game* game);
+
+// Sauvegarder : le premier appel ouvre un journal, les coups suivants y sont ajoutés
+// et chaque appel écrit ce qui reste en mémoire. 1 si réussi.
+CHESS_API int chess_game_save(chess_game* game, const char* filename);
+
+// Charger un journal (la partie continue dans le même fichier), une sauvegarde texte
+// de chess2 ou une ancienne sauvegarde brute de chess.c. 1 si réussi.
+CHESS_API int chess_game_load(chess_game* game, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef CHESS_EVAL_H
+#define CHESS_EVAL_H
+
+#include <cstdio>
+#include <cstdlib>
+#include "position.h"
+
+// Évaluation du point de vue du joueur au trait : matériel et tables pièce-case,
+// lus dans les accumulateurs tenus à jour par les coups. Avec CHESS_DEBUG_EVAL,
+// chaque appel vérifie l'état incrémental contre un recalcul complet.
+inline int evaluate(const Position& pos) {
+#ifdef CHESS_DEBUG_EVAL
+    if (!position_is_consistent(&pos)) {
+        fprintf(stderr, "État incrémental incohérent : %s\n", position_to_text(&pos).c_str());
+        abort();
+    }
+#endif
+    Player us = pos.sideToMove;
+    Player them = us == PLAYER1 ? PLAYER2 : PLAYER1;
+    return (pos.state.material[us] + pos.state.pst[us]) - (pos.state.material[them] + pos.state.pst[them]);
+}
+
+#endif
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <fstream>  // Pour ifstream et ofstream
+#include <algorithm>
+#include "game.h"
+#include "journal.h"
+#include "instrument.h"
+
+// Enregistrer la partie dans un fichier
+void save_game(Game* game, const char* filename) {
+    CHESS_TIMED(TIMER_SAVE);
+    std::ofstream file(filename);
+    if (file.is_open()) {
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            for (int x = 0; x < BOARD_SIZE; x++) {
+                uint8_t code = game->pos.squares[square_of(x, y)];
+                if (code != 0) {
+                    file << code_type(code) << " " << code_player(code) << " ";
+                } else {
+                    file << "-1 "; // -1 pour une case vide
+                }
+            }
+            file << std::endl;
+        }
+        file << game->pos.sideToMove << std::endl;
+        file.close();
+    } else {
+        std::cerr << "Erreur d'ouverture du fichier pour la sauvegarde." << std::endl;
+    }
+}
+
+// Charger une partie à partir d'un fichier ; la partie n'est modifiée que si tout
+// le fichier a pu être lu
+bool load_game(Game* game, const char* filename) {
+    CHESS_TIMED(TIMER_LOAD);
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erreur d'ouverture du fichier pour le chargement." << std::endl;
+        return false;
+    }
+    Position pos;
+    clear_position(&pos);
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            int type, player;
+            file >> type;
+            if (!file) {
+                std::cerr << "Sauvegarde illisible." << std::endl;
+                return false;
+            }
+            if (type != -1) { // Une case vide n'a pas de joueur dans le fichier
+                file >> player;
+                if (!file || type <= EMPTY || type > BISHOP || (player != PLAYER1 && player != PLAYER2)
+                    || pos.counts[player][EMPTY] >= MAX_PIECES) {
+                    std::cerr << "Pièce invalide dans la sauvegarde." << std::endl;
+                    return false;
+                }
+                put_piece(&pos, square_of(x, y), static_cast<PieceType>(type), static_cast<Player>(player));
+            }
+        }
+    }
+    int currentPlayer;
+    file >> currentPlayer;
+    if (!file || (currentPlayer != PLAYER1 && currentPlayer != PLAYER2)) {
+        std::cerr << "Sauvegarde illisible." << std::endl;
+        return false;
+    }
+    set_side_to_move(&pos, static_cast<Player>(currentPlayer));
+    game->pos = pos;
+    game->keys.clear();
+    return true;
+}
+
+static int32_t read_i32(const unsigned char* p) {
+    return static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24));
+}
+
+// Lire une sauvegarde brute de l'ancien chess.c
+bool load_legacy_save(Game* game, const unsigned char* bytes, size_t size) {
+    if (size != LEGACY_SAVE_SIZE) {
+        return false;
+    }
+    int32_t player = read_i32(bytes);
+    if (player != PLAYER1 && player != PLAYER2) {
+        return false;
+    }
+    Position pos;
+    clear_position(&pos);
+    for (int x = 0; x < BOARD_SIZE; x++) {
+        for (int y = 0; y < BOARD_SIZE; y++) {
+            const unsigned char* piece = bytes + 4 + 8 * (x * BOARD_SIZE + y);
+            int32_t type = read_i32(piece);
+            int32_t owner = read_i32(piece + 4);
+            if (type == EMPTY) {
+                continue;
+            }
+            if (type < QUEEN || type > BISHOP || (owner != PLAYER1 && owner != PLAYER2)
+                || pos.counts[owner][EMPTY] >= MAX_PIECES) {
+                return false;
+            }
+            put_piece(&pos, square_of(x, y), static_cast<PieceType>(type), static_cast<Player>(owner));
+        }
+    }
+    set_side_to_move(&pos, static_cast<Player>(player));
+    game->pos = pos;
+    game->keys.clear();
+    return true;
+}
+
+// Effectuer un mouvement pour l'interface : retourne false si le coup est refusé
+bool make_move(Game* game, int fromX, int fromY, int toX, int toY) {
+    CHESS_TIMED(TIMER_MOVE);
+    if (!on_board(fromX, fromY) || !on_board(toX, toY)) {
+        return false; // Clic hors du plateau
+    }
+    uint8_t code = game->pos.squares[square_of(fromX, fromY)];
+    if (code == 0 || code_player(code) != game->pos.sideToMove) {
+        return false; // Aucune pièce à déplacer ou mauvaise pièce
+    }
+    if (!is_valid_move(&game->pos, fromX, fromY, toX, toY)) {
+        return false;
+    }
+    int to = square_of(toX, toY);
+    Move m = encode_move(square_of(fromX, fromY), to, code_type(game->pos.squares[to]));
+    game->keys.push_back(game->pos.state.key);
+    apply_move(game->pos, m);
+    CHESS_COUNT(COUNTER_MOVES, 1);
+    if (game->journal != nullptr) {
+        game->journal->append(m, game->pos);
+    }
+    if (game->writer != nullptr) {
+        game->writer->push(m);
+    }
+    return true;
+}
+
+// Fonction pour vérifier si un joueur a encore des pièces
+bool hasRemainingPieces(const Position* pos, Player player) {
+    return pos->counts[player][EMPTY] != 0;
+}
+
+// Fonction pour vérifier si la position courante est apparue trois fois
+bool isThreefoldRepetition(const Game* game) {
+    int size = static_cast<int>(game->keys.size());
+    int limit = std::min<int>(game->pos.state.pliesSinceCapture, size);
+    int occurrences = 1;
+    for (int back = 2; back <= limit; back += 2) {
+        if (game->keys[size - back] == game->pos.state.key && ++occurrences >= 3) {
+            return true;
+        }
+    }
+    return false;
+}
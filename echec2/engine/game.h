@@ -0,0 +1,39 @@
+#ifndef CHESS_GAME_H
+#define CHESS_GAME_H
+
+#include <vector>
+#include "position.h"
+
+class Journal;
+class JournalWriter;
+
+// Structure pour représenter une partie
+struct Game {
+    Position pos;
+    std::vector<uint64_t> keys; // Clés des positions déjà jouées, pour détecter les répétitions
+    Journal* journal = nullptr; // Si présent, chaque coup joué y est ajouté
+    JournalWriter* writer = nullptr; // Idem, l'écriture étant faite par un autre thread
+};
+
+// Enregistrer la partie dans un fichier
+void save_game(Game* game, const char* filename);
+
+// Charger une partie à partir d'un fichier ; false si le fichier est illisible
+bool load_game(Game* game, const char* filename);
+
+// Lire une sauvegarde brute de l'ancien chess.c : le joueur au trait puis 64 structures
+// Piece { type, player } écrites telles quelles (entiers de 4 octets en petit-boutiste,
+// grid[x][y] avec x en premier). false si les octets n'ont pas ce format.
+#define LEGACY_SAVE_SIZE (4 + SQUARE_COUNT * 8)
+bool load_legacy_save(Game* game, const unsigned char* bytes, size_t size);
+
+// Effectuer un mouvement pour l'interface : retourne false si le coup est refusé
+bool make_move(Game* game, int fromX, int fromY, int toX, int toY);
+
+// Fonction pour vérifier si un joueur a encore des pièces
+bool hasRemainingPieces(const Position* pos, Player player);
+
+// Fonction pour vérifier si la position courante est apparue trois fois
+bool isThreefoldRepetition(const Game* game);
+
+#endif
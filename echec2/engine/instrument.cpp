@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include "instrument.h"
+
+static const char* COUNTER_NAMES[COUNTER_COUNT] = {
+    "nodes", "qnodes", "tt_probes", "tt_hits", "cutoffs", "first_move_cutoffs", "tb_hits", "book_hits", "searches", "moves", "playouts"
+};
+static const char* TIMER_NAMES[TIMER_COUNT] = {"frame", "search", "move", "save", "load"};
+
+// Threads vivants et totaux des threads terminés
+static std::mutex registryMutex;
+static std::vector<ThreadCounters*>& live_threads() {
+    static std::vector<ThreadCounters*> threads;
+    return threads;
+}
+static uint64_t retired[COUNTER_COUNT];
+
+static Histogram timers[TIMER_COUNT];
+
+ThreadCounters::ThreadCounters() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    live_threads().push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<ThreadCounters*>& threads = live_threads();
+    threads.erase(std::remove(threads.begin(), threads.end(), this), threads.end());
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        retired[c] += values[c].load(std::memory_order_relaxed);
+    }
+}
+
+Histogram& instrument_timer(Timer timer) {
+    return timers[timer];
+}
+
+uint64_t Histogram::percentile(double p) const {
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p / 100.0 * count() + 0.5)), seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            if (b < SUB) {
+                return static_cast<uint64_t>(b);
+            }
+            int high = b / SUB + 2, sub = b % SUB;
+            return std::min(max(), (static_cast<uint64_t>(SUB + sub + 1) << (high - 3)) - 1);
+        }
+    }
+    return max();
+}
+
+static double ratio(uint64_t part, uint64_t whole) {
+    return whole > 0 ? static_cast<double>(part) / whole : 0;
+}
+
+std::string instrument_json() {
+    uint64_t totals[COUNTER_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            totals[c] = retired[c];
+            for (ThreadCounters* t : live_threads()) {
+                totals[c] += t->values[c].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    const Histogram& search = timers[TIMER_SEARCH];
+    double searchSeconds = search.mean() * search.count() / 1e6;
+
+    std::ostringstream json;
+    json << "{\"instrumented\":" <<
+#ifdef CHESS_INSTRUMENT
+        "true"
+#else
+        "false"
+#endif
+         << ",\"counters\":{";
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+        json << (c > 0 ? "," : "") << "\"" << COUNTER_NAMES[c] << "\":" << totals[c];
+    }
+    json << "},\"search\":{\"tt_hit_rate\":" << ratio(totals[COUNTER_TT_HITS], totals[COUNTER_TT_PROBES])
+         << ",\"first_move_cutoff_rate\":" << ratio(totals[COUNTER_FIRST_MOVE_CUTOFFS], totals[COUNTER_CUTOFFS])
+         << ",\"qnode_share\":" << ratio(totals[COUNTER_QNODES], totals[COUNTER_NODES])
+         << ",\"nps\":" << static_cast<uint64_t>(searchSeconds > 0 ? totals[COUNTER_NODES] / searchSeconds : 0)
+         << "},\"timers_us\":{";
+    for (int t = 0; t < TIMER_COUNT; t++) {
+        const Histogram& h = timers[t];
+        json << (t > 0 ? "," : "") << "\"" << TIMER_NAMES[t] << "\":{\"count\":" << h.count()
+             << ",\"mean\":" << h.mean() << ",\"p50\":" << h.percentile(50) << ",\"p90\":" << h.percentile(90)
+             << ",\"p99\":" << h.percentile(99) << ",\"max\":" << h.max() << "}";
+    }
+    json << "}}";
+    return json.str();
+}
+
+bool instrument_dump(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::string json = instrument_json();
+    bool ok = fputs(json.c_str(), file) >= 0 && fputc('\n', file) != EOF;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,129 @@
+#ifndef CHESS_INSTRUMENT_H
+#define CHESS_INSTRUMENT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Instrumentation : compteurs par thread, chronomètres de portée et histogrammes de
+// durées, exportés en JSON à la demande. Sans CHESS_INSTRUMENT (option CMake du même
+// nom), les macros CHESS_COUNT et CHESS_TIMED disparaissent à la compilation ; la
+// recherche ne compte alors plus ses statistiques détaillées.
+
+// Compteurs, tenus par chaque thread puis additionnés à l'export
+enum Counter {
+    COUNTER_NODES,              // Noeuds de recherche, quiescence comprise
+    COUNTER_QNODES,             // Noeuds de quiescence
+    COUNTER_TT_PROBES,
+    COUNTER_TT_HITS,
+    COUNTER_CUTOFFS,            // Coupures bêta hors quiescence
+    COUNTER_FIRST_MOVE_CUTOFFS, // Dont celles obtenues par le premier coup essayé
+    COUNTER_TB_HITS,
+    COUNTER_BOOK_HITS,          // Coups joués depuis le livre d'ouverture
+    COUNTER_SEARCHES,
+    COUNTER_MOVES,              // Coups joués dans les parties
+    COUNTER_PLAYOUTS,           // Parties simulées par la recherche Monte-Carlo
+    COUNTER_COUNT
+};
+
+// Chronomètres, un histogramme de durées chacun
+enum Timer {
+    TIMER_FRAME,  // Une image de l'interface
+    TIMER_SEARCH, // Une recherche complète
+    TIMER_MOVE,   // Un coup joué par make_move
+    TIMER_SAVE,   // Écriture d'une sauvegarde ou d'un journal
+    TIMER_LOAD,   // Lecture d'une sauvegarde ou d'un journal
+    TIMER_COUNT
+};
+
+// Histogramme sans verrou : 8 sous-intervalles par puissance de deux, soit une
+// précision d'environ 10 % sur les percentiles
+class Histogram {
+public:
+    void record(uint64_t value) {
+        buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t previous = largest.load(std::memory_order_relaxed);
+        while (value > previous && !largest.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return largest.load(std::memory_order_relaxed); }
+    double mean() const { return count() > 0 ? static_cast<double>(sum.load(std::memory_order_relaxed)) / count() : 0; }
+
+    // Borne haute du percentile demandé (0 à 100)
+    uint64_t percentile(double p) const;
+
+private:
+    static const int SUB = 8;
+    static const int BUCKETS = 62 * SUB;
+
+    static int bucket_of(uint64_t v) {
+        if (v < SUB) {
+            return static_cast<int>(v);
+        }
+        int high = 63 - __builtin_clzll(v); // Au moins 3
+        return (high - 2) * SUB + static_cast<int>((v >> (high - 3)) & (SUB - 1));
+    }
+
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> total{0}, sum{0}, largest{0};
+};
+
+// Compteurs d'un thread : seul ce thread les modifie, l'export les lit à tout moment
+struct ThreadCounters {
+    std::atomic<uint64_t> values[COUNTER_COUNT] = {};
+    ThreadCounters();
+    ~ThreadCounters(); // Les totaux d'un thread qui se termine sont gardés
+};
+
+inline ThreadCounters& thread_counters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+// Ajouter n à un compteur du thread courant, sans instruction atomique coûteuse
+inline void instrument_add(Counter counter, uint64_t n) {
+    std::atomic<uint64_t>& value = thread_counters().values[counter];
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Histogramme d'un chronomètre, en microsecondes
+Histogram& instrument_timer(Timer timer);
+
+// Mesurer la durée d'une portée
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer t) : timer(t), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        instrument_timer(timer).record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+private:
+    Timer timer;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef CHESS_INSTRUMENT
+#define CHESS_COUNT(counter, n) instrument_add(counter, n)
+#define CHESS_TIMED_NAME(line) chessTimer##line
+#define CHESS_TIMED_AT(timer, line) ScopedTimer CHESS_TIMED_NAME(line)(timer)
+#define CHESS_TIMED(timer) CHESS_TIMED_AT(timer, __LINE__)
+#else
+#define CHESS_COUNT(counter, n) ((void)0)
+#define CHESS_TIMED(timer) ((void)0)
+#endif
+
+// Toutes les mesures en JSON : compteurs additionnés sur les threads, taux dérivés
+// (succès de la table de transposition, coupures au premier coup, noeuds par seconde)
+// et percentiles de chaque chronomètre
+std::string instrument_json();
+
+// Écrire instrument_json dans un fichier ; false en cas d'erreur
+bool instrument_dump(const char* filename);
+
+#endif
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <unistd.h>  // Pour ftruncate
+#include "journal.h"
+#include "movegen.h"
+#include "instrument.h"
+
+static const char JOURNAL_MAGIC[8] = {'Q', 'N', 'R', 'B', 'J', 'R', 'N', '1'};
+
+// Géométrie d'un journal, déduite de son en-tête et de sa taille
+struct JournalLayout {
+    uint32_t interval;
+    uint32_t lastPly;      // Demi-coups complets dans le fichier
+    uint32_t checkpoints;  // Points de contrôle complets
+    size_t validSize;      // Taille sans le dernier enregistrement tronqué
+};
+
+// Un bloc : un point de contrôle et les interval coups qui le suivent
+static size_t block_size(uint32_t interval) {
+    return JOURNAL_CHECKPOINT_SIZE + static_cast<size_t>(JOURNAL_MOVE_SIZE) * interval;
+}
+
+// Position dans le fichier du coup qui mène au demi-coup ply + 1
+static size_t move_offset(uint32_t interval, uint32_t ply) {
+    return JOURNAL_HEADER_SIZE + (ply / interval) * block_size(interval) + JOURNAL_CHECKPOINT_SIZE
+         + static_cast<size_t>(JOURNAL_MOVE_SIZE) * (ply % interval);
+}
+
+static bool read_layout(FILE* file, JournalLayout& layout) {
+    uint8_t header[JOURNAL_HEADER_SIZE];
+    if (fseek(file, 0, SEEK_SET) != 0 || fread(header, sizeof(header), 1, file) != 1
+        || memcmp(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        return false;
+    }
+    uint32_t version = header[8] | (header[9] << 8) | (header[10] << 16) | (static_cast<uint32_t>(header[11]) << 24);
+    layout.interval = header[12] | (header[13] << 8) | (header[14] << 16) | (static_cast<uint32_t>(header[15]) << 24);
+    if (version != JOURNAL_VERSION || layout.interval == 0 || fseek(file, 0, SEEK_END) != 0) {
+        return false;
+    }
+    size_t body = static_cast<size_t>(ftell(file)) - JOURNAL_HEADER_SIZE;
+    size_t block = block_size(layout.interval);
+    uint32_t full = static_cast<uint32_t>(body / block);
+    size_t rest = body % block;
+    if (rest >= JOURNAL_CHECKPOINT_SIZE) {
+        uint32_t moves = static_cast<uint32_t>((rest - JOURNAL_CHECKPOINT_SIZE) / JOURNAL_MOVE_SIZE);
+        layout.lastPly = full * layout.interval + moves;
+        layout.checkpoints = full + 1;
+        layout.validSize = move_offset(layout.interval, full * layout.interval) + JOURNAL_MOVE_SIZE * moves;
+    } else {
+        if (full == 0) {
+            return false; // Pas même la position de départ
+        }
+        layout.lastPly = full * layout.interval;
+        layout.checkpoints = full; // Le point de contrôle du dernier bloc n'a pas été écrit
+        layout.validSize = JOURNAL_HEADER_SIZE + full * block;
+    }
+    return true;
+}
+
+// Lire le point de contrôle d'un bloc
+static bool read_checkpoint(FILE* file, uint32_t interval, uint32_t index, Position* pos) {
+    uint8_t record[JOURNAL_CHECKPOINT_SIZE];
+    uint32_t ply;
+    return fseek(file, static_cast<long>(JOURNAL_HEADER_SIZE + index * block_size(interval)), SEEK_SET) == 0
+        && fread(record, sizeof(record), 1, file) == 1 && record[0] == 'C'
+        && unpack_position(record + 1, pos, &ply) && ply == index * interval;
+}
+
+bool Journal::create(const char* filename, const Position& start, int checkpointInterval) {
+    close();
+    file = fopen(filename, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    interval = static_cast<uint32_t>(std::max(1, checkpointInterval));
+    uint8_t header[JOURNAL_HEADER_SIZE] = {};
+    memcpy(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    for (int b = 0; b < 4; b++) {
+        header[8 + b] = static_cast<uint8_t>(JOURNAL_VERSION >> (8 * b));
+        header[12 + b] = static_cast<uint8_t>(interval >> (8 * b));
+    }
+    ply = 0;
+    pendingMoves = 0;
+    buffered = 0;
+    if (fwrite(header, sizeof(header), 1, file) != 1) {
+        close();
+        return false;
+    }
+    buffer_checkpoint(start);
+    return flush();
+}
+
+bool Journal::resume(const char* filename, Game* game) {
+    close();
+    uint32_t last;
+    if (!journal_load(filename, game, JOURNAL_LAST_PLY, &last)) {
+        return false;
+    }
+    file = fopen(filename, "r+b");
+    JournalLayout layout;
+    if (file == nullptr || !read_layout(file, layout)) {
+        close();
+        return false;
+    }
+    // Effacer un enregistrement tronqué avant d'ajouter à la suite
+    fflush(file);
+    if (ftruncate(fileno(file), static_cast<off_t>(layout.validSize)) != 0 || fseek(file, 0, SEEK_END) != 0) {
+        close();
+        return false;
+    }
+    interval = layout.interval;
+    ply = last;
+    pendingMoves = 0;
+    buffered = 0;
+    if (ply % interval == 0 && ply / interval >= layout.checkpoints) {
+        buffer_checkpoint(game->pos); // Point de contrôle perdu lors de l'arrêt
+        return flush();
+    }
+    return true;
+}
+
+void Journal::buffer_checkpoint(const Position& pos) {
+    buffer[buffered] = 'C';
+    pack_position(&pos, ply, buffer + buffered + 1);
+    buffered += JOURNAL_CHECKPOINT_SIZE;
+}
+
+bool Journal::append(Move m, const Position& after) {
+    if (file == nullptr) {
+        return false;
+    }
+    buffer[buffered] = 'M';
+    buffer[buffered + 1] = static_cast<uint8_t>(m & 0xFF);
+    buffer[buffered + 2] = static_cast<uint8_t>(m >> 8);
+    buffered += JOURNAL_MOVE_SIZE;
+    pendingMoves++;
+    ply++;
+    if (ply % interval == 0) {
+        buffer_checkpoint(after);
+        return flush(); // Un point de contrôle est toujours écrit tout de suite
+    }
+    return pendingMoves >= JOURNAL_FLUSH_MOVES ? flush() : true;
+}
+
+bool Journal::flush() {
+    CHESS_TIMED(TIMER_SAVE);
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = buffered == 0 || fwrite(buffer, 1, buffered, file) == buffered;
+    buffered = 0;
+    pendingMoves = 0;
+    return fflush(file) == 0 && ok;
+}
+
+void Journal::close() {
+    if (file != nullptr) {
+        flush();
+        fclose(file);
+        file = nullptr;
+    }
+}
+
+bool JournalWriter::start(const std::string& name, const Position& start, int interval) {
+    if (is_running()) {
+        return false;
+    }
+    filename = name;
+    pos = start;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    quit.store(false, std::memory_order_relaxed);
+    thread = std::thread(&JournalWriter::run, this, true, interval);
+    return true;
+}
+
+bool JournalWriter::resume(const char* name, Game* game) {
+    if (is_running() || !journal.resume(name, game)) {
+        return false;
+    }
+    filename = name;
+    pos = game->pos;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    quit.store(false, std::memory_order_relaxed);
+    thread = std::thread(&JournalWriter::run, this, false, JOURNAL_DEFAULT_INTERVAL);
+    return true;
+}
+
+void JournalWriter::push(Move m) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    // File pleine : le disque a des centaines de coups de retard, on lui laisse la main
+    while (h - tail.load(std::memory_order_acquire) >= JOURNAL_QUEUE_SIZE) {
+        std::this_thread::yield();
+    }
+    queue[h % JOURNAL_QUEUE_SIZE] = m;
+    head.store(h + 1, std::memory_order_release);
+    wake.notify_one();
+}
+
+void JournalWriter::request_flush() {
+    flushRequested.store(true, std::memory_order_release);
+    wake.notify_one();
+}
+
+void JournalWriter::close() {
+    if (!is_running()) {
+        return;
+    }
+    quit.store(true, std::memory_order_release);
+    wake.notify_one();
+    thread.join();
+}
+
+void JournalWriter::run(bool create, int interval) {
+    bool ok = !create || journal.create(filename.c_str(), pos, interval);
+    if (!ok) {
+        std::cerr << "Impossible de créer le journal " << filename << std::endl;
+    }
+    for (;;) {
+        {
+            // Le réveil peut se perdre (notify sans verrou) : l'attente est donc bornée
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                return head.load(std::memory_order_acquire) != tail.load(std::memory_order_relaxed)
+                    || flushRequested.load(std::memory_order_acquire) || quit.load(std::memory_order_acquire);
+            });
+        }
+        bool stopping = quit.load(std::memory_order_acquire);
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        uint32_t h = head.load(std::memory_order_acquire);
+        for (; t != h; t++) {
+            Move m = queue[t % JOURNAL_QUEUE_SIZE];
+            apply_move(pos, m);
+            ok = journal.append(m, pos) && ok;
+        }
+        tail.store(t, std::memory_order_release);
+        if (flushRequested.exchange(false, std::memory_order_acq_rel)) {
+            if (journal.flush() && ok) {
+                std::cout << "Partie sauvegardée dans " << filename << " (" << journal.plies()
+                          << " demi-coups journalisés)." << std::endl;
+            } else {
+                std::cerr << "Erreur d'écriture de la sauvegarde." << std::endl;
+            }
+        }
+        if (stopping) {
+            journal.close();
+            return;
+        }
+    }
+}
+
+bool journal_load(const char* filename, Game* game, uint32_t ply, uint32_t* lastPly) {
+    CHESS_TIMED(TIMER_LOAD);
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    JournalLayout layout;
+    if (!read_layout(file, layout)) {
+        fclose(file);
+        return false;
+    }
+    uint32_t k = layout.interval;
+    uint32_t target = std::min(ply, layout.lastPly);
+    uint32_t index = std::min(target / k, layout.checkpoints - 1);
+
+    // Remonter jusqu'à la dernière prise pour retrouver les clés des répétitions
+    Position pos;
+    if (!read_checkpoint(file, k, index, &pos)) {
+        fclose(file);
+        return false;
+    }
+    uint32_t from = index * k - std::min<uint32_t>(pos.state.pliesSinceCapture, index * k);
+    uint32_t first = from / k;
+    if (first != index && !read_checkpoint(file, k, first, &pos)) {
+        fclose(file);
+        return false;
+    }
+
+    // Lire d'un bloc tous les enregistrements à rejouer
+    uint32_t start = first * k;
+    std::vector<uint8_t> bytes;
+    if (target > start) {
+        size_t begin = move_offset(k, start);
+        bytes.resize(move_offset(k, target - 1) + JOURNAL_MOVE_SIZE - begin);
+        if (fseek(file, static_cast<long>(begin), SEEK_SET) != 0 || fread(bytes.data(), bytes.size(), 1, file) != 1) {
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+
+    // Rejouer à part : la partie n'est remplacée que si tous les coups sont valides
+    std::vector<uint64_t> keys;
+    size_t base = move_offset(k, start);
+    for (uint32_t p = start; p < target; p++) {
+        const uint8_t* record = bytes.data() + (move_offset(k, p) - base);
+        Move m = static_cast<Move>(record[1] | (record[2] << 8));
+        if (record[0] != 'M' || !is_pseudo_legal(pos, m)) {
+            return false;
+        }
+        keys.push_back(pos.state.key);
+        apply_move(pos, m);
+        if (pos.state.pliesSinceCapture == 0) {
+            keys.clear(); // Aucune position d'avant la prise ne peut revenir
+        }
+    }
+    game->pos = pos;
+    game->keys.swap(keys);
+    if (lastPly != nullptr) {
+        *lastPly = layout.lastPly;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef CHESS_JOURNAL_H
+#define CHESS_JOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "archive.h"
+#include "game.h"
+
+// Journal de partie en ajout seul : un enregistrement de 3 octets par coup et, tous
+// les K coups, un point de contrôle (la position compacte de archive.h). Sauvegarder
+// ne coûte plus que l'ajout du dernier coup, quelle que soit la longueur de la partie.
+//
+// En-tête de 16 octets (magic "QNRBJRN1", version u32, K u32), puis des blocs de taille
+// fixe : le point de contrôle du demi-coup c * K ('C' puis 32 octets) suivi des K coups
+// suivants ('M' puis le coup sur 2 octets, petit-boutiste). La position de n'importe
+// quel demi-coup se retrouve donc sans parcourir le fichier : on lit le point de
+// contrôle du bloc et on rejoue au plus K coups. Un dernier enregistrement tronqué
+// (arrêt brutal) est ignoré à la lecture et effacé à la reprise.
+
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_SIZE 16
+#define JOURNAL_CHECKPOINT_SIZE (1 + PACKED_POSITION_SIZE)
+#define JOURNAL_MOVE_SIZE 3
+#define JOURNAL_DEFAULT_INTERVAL 32 // Coups entre deux points de contrôle
+#define JOURNAL_FLUSH_MOVES 16      // Coups gardés en mémoire avant d'écrire
+#define JOURNAL_LAST_PLY 0xFFFFFFFFu
+#define JOURNAL_QUEUE_SIZE 1024     // Coups en transit vers le thread d'écriture (puissance de 2)
+
+class Journal {
+public:
+    ~Journal() { close(); }
+
+    // Commencer un journal (le fichier est remplacé) à partir de la position donnée
+    bool create(const char* filename, const Position& start, int interval = JOURNAL_DEFAULT_INTERVAL);
+
+    // Rouvrir un journal pour continuer la partie : game reçoit la dernière position
+    bool resume(const char* filename, Game* game);
+
+    // Enregistrer un coup ; after est la position obtenue après le coup
+    bool append(Move m, const Position& after);
+
+    // Écrire les enregistrements en attente
+    bool flush();
+    void close();
+
+    bool is_open() const { return file != nullptr; }
+    uint32_t plies() const { return ply; }
+
+private:
+    void buffer_checkpoint(const Position& pos);
+
+    FILE* file = nullptr;
+    uint32_t interval = JOURNAL_DEFAULT_INTERVAL;
+    uint32_t ply = 0;      // Demi-coups enregistrés depuis le début de la partie
+    int pendingMoves = 0;  // Coups en mémoire pas encore écrits
+    size_t buffered = 0;
+    uint8_t buffer[JOURNAL_FLUSH_MOVES * JOURNAL_MOVE_SIZE + JOURNAL_CHECKPOINT_SIZE];
+};
+
+// Journal tenu par un thread d'écriture, pour qu'une interface ne touche jamais au
+// disque : le thread de jeu dépose chaque coup dans une file circulaire sans verrou
+// (un producteur, un consommateur) et revient aussitôt. Le thread d'écriture rejoue
+// les coups sur sa propre copie de la position, dont il tire les points de contrôle.
+class JournalWriter {
+public:
+    ~JournalWriter() { close(); }
+
+    // Commencer un journal ; le fichier est créé par le thread d'écriture
+    bool start(const std::string& filename, const Position& start, int interval = JOURNAL_DEFAULT_INTERVAL);
+
+    // Reprendre un journal : la lecture se fait ici, au chargement, puis le thread démarre
+    bool resume(const char* filename, Game* game);
+
+    // Confier un coup au journal, sans attendre le disque
+    void push(Move m);
+
+    // Demander l'écriture de tout ce qui est en attente ; le thread en rend compte
+    void request_flush();
+
+    // Écrire ce qui reste, fermer le fichier et arrêter le thread
+    void close();
+
+    bool is_running() const { return thread.joinable(); }
+
+private:
+    void run(bool create, int interval);
+
+    Journal journal;               // N'est touché que par le thread d'écriture
+    std::string filename;
+    Position pos;                  // Position après le dernier coup écrit
+
+    Move queue[JOURNAL_QUEUE_SIZE];
+    std::atomic<uint32_t> head{0}; // Prochain coup déposé (thread de jeu)
+    std::atomic<uint32_t> tail{0}; // Prochain coup écrit (thread d'écriture)
+    std::atomic<bool> flushRequested{false};
+    std::atomic<bool> quit{false};
+
+    std::mutex mutex;              // Seulement pour dormir en attendant du travail
+    std::condition_variable wake;
+    std::thread thread;
+};
+
+// Reconstruire la partie au demi-coup demandé (le dernier par défaut), avec les clés
+// nécessaires aux répétitions. lastPly reçoit le nombre de demi-coups du journal.
+bool journal_load(const char* filename, Game* game, uint32_t ply = JOURNAL_LAST_PLY, uint32_t* lastPly = nullptr);
+
+#endif
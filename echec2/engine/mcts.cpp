@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "mcts.h"
+#include "attacks.h"
+#include "movegen.h"
+#include "tablebase.h"
+#include "instrument.h"
+
+typedef std::chrono::steady_clock Clock;
+
+#define UCT_EXPLORATION 1.0  // Poids de l'exploration dans UCT, pour des gains entre 0 et 1
+#define EXPAND_VISITS 2      // Visites d'une feuille avant la création de ses enfants
+#define ROLLOUT_WIN_MARGIN 300 // Avance matérielle qui gagne une simulation trop longue
+#define PLAYOUT_BATCH 64     // Simulations entre deux lectures de l'horloge
+
+const int DRAW = 2; // Issue d'une simulation : PLAYER1, PLAYER2 ou DRAW
+
+// États d'un noeud, rangés dans l'indice de ses enfants : la racine occupe l'indice 0,
+// qui ne peut donc jamais être celui d'un premier enfant
+const uint32_t NODE_LEAF = 0;
+const uint32_t NODE_EXPANDING = UINT32_MAX;
+
+// Un noeud de l'arbre : le coup qui y mène, ses visites (pertes virtuelles comprises)
+// et ses gains en demi-points pour le joueur qui a joué ce coup
+struct MctsNode {
+    std::atomic<uint32_t> visits;
+    std::atomic<uint32_t> reward;
+    std::atomic<uint32_t> children; // NODE_LEAF, NODE_EXPANDING ou indice du premier enfant
+    uint16_t childCount;            // Écrit avant la publication de children
+    Move move;
+
+    void init(Move m) {
+        visits.store(0, std::memory_order_relaxed);
+        reward.store(0, std::memory_order_relaxed);
+        children.store(NODE_LEAF, std::memory_order_relaxed);
+        childCount = 0;
+        move = m;
+    }
+};
+static_assert(sizeof(MctsNode) == 16, "Un noeud doit rester compact");
+
+MctsArena::MctsArena(uint32_t capacity) : nodes(new MctsNode[capacity]), size(capacity) {}
+
+MctsArena::~MctsArena() = default;
+
+void MctsArena::reset() {
+    used.store(0, std::memory_order_relaxed);
+}
+
+bool MctsArena::full() const {
+    return used.load(std::memory_order_relaxed) >= size;
+}
+
+uint32_t MctsArena::allocate(uint32_t n) {
+    uint32_t first = used.fetch_add(n, std::memory_order_relaxed);
+    return first + n <= size ? first : NODE_LEAF;
+}
+
+MctsNode& MctsArena::operator[](uint32_t index) {
+    return nodes[index];
+}
+
+// Arbre partagé par les threads d'une recherche
+struct MctsTree {
+    MctsArena* arena;
+    Position root;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> playouts{0};
+    uint64_t playoutLimit = 0;
+};
+
+// Tirer un coup uniformément parmi ceux qui arrivent dans allowed, sans remplir de
+// liste : cibles de chaque pièce, puis le r-ième bit du total
+static Move random_move(const Position& pos, Prng& rng, Bitboard allowed) {
+    Player us = pos.sideToMove;
+    Bitboard occupied = pos.occupied[PLAYER1] | pos.occupied[PLAYER2];
+    Bitboard targets[MAX_PIECES];
+    int count = pos.counts[us][EMPTY], total = 0;
+    for (int i = 0; i < count; i++) {
+        int from = pos.pieceList[us][i];
+        targets[i] = attacks_from(code_type(pos.squares[from]), from, occupied) & allowed;
+        total += popcount(targets[i]);
+    }
+    if (total == 0) {
+        return MOVE_NONE;
+    }
+    int r = static_cast<int>(rng.next() % total);
+    for (int i = 0;; i++) {
+        int n = popcount(targets[i]);
+        if (r < n) {
+            Bitboard t = targets[i];
+            while (r-- > 0) {
+                t &= t - 1;
+            }
+            int to = lsb(t);
+            return encode_move(pos.pieceList[us][i], to, code_type(pos.squares[to]));
+        }
+        r -= n;
+    }
+}
+
+// Partie simulée depuis pos, une prise étant préférée une fois sur deux quand il y en a.
+// Rend le gagnant ou DRAW.
+static int rollout(Position& pos, Prng& rng, uint64_t& nodes) {
+    for (int ply = 0; ply < MCTS_ROLLOUT_PLIES; ply++) {
+        Player us = pos.sideToMove;
+        Player them = us == PLAYER1 ? PLAYER2 : PLAYER1;
+        if (pos.counts[us][EMPTY] == 0) {
+            return them;
+        }
+        Move m = (rng.next() & 1) ? random_move(pos, rng, pos.occupied[them]) : MOVE_NONE;
+        if (m == MOVE_NONE) {
+            m = random_move(pos, rng, ~pos.occupied[us]);
+        }
+        if (m == MOVE_NONE) {
+            return DRAW; // Aucun coup possible
+        }
+        apply_move(pos, m);
+        nodes++;
+    }
+    // Simulation trop longue : jugée sur le matériel
+    int balance = evaluate(pos);
+    Player us = pos.sideToMove;
+    if (balance > ROLLOUT_WIN_MARGIN) {
+        return us;
+    }
+    return balance < -ROLLOUT_WIN_MARGIN ? (us == PLAYER1 ? PLAYER2 : PLAYER1) : DRAW;
+}
+
+// Créer les enfants d'un noeud que ce thread vient de passer à NODE_EXPANDING
+static uint32_t expand(MctsArena& arena, MctsNode& node, const Position& pos) {
+    MoveList list;
+    generate_moves(pos, list);
+    uint32_t first = arena.allocate(list.size);
+    if (first == NODE_LEAF) {
+        node.children.store(NODE_LEAF, std::memory_order_release); // Réserve pleine : le noeud reste une feuille
+        return NODE_LEAF;
+    }
+    for (int i = 0; i < list.size; i++) {
+        arena[first + i].init(list.moves[i]);
+    }
+    node.childCount = static_cast<uint16_t>(list.size);
+    node.children.store(first, std::memory_order_release);
+    return first;
+}
+
+// Enfant au meilleur score UCT ; un enfant jamais visité passe avant tous les autres
+static uint32_t select_child(MctsArena& arena, const MctsNode& parent, uint32_t first) {
+    double logVisits = std::log(static_cast<double>(std::max(1u, parent.visits.load(std::memory_order_relaxed))));
+    uint32_t best = first;
+    double bestValue = -1;
+    for (uint32_t i = first; i < first + parent.childCount; i++) {
+        const MctsNode& child = arena[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        double value = child.reward.load(std::memory_order_relaxed) / (2.0 * visits)
+                     + UCT_EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Une simulation : descente, extension, partie au hasard, remontée. Chaque noeud du
+// chemin reçoit sa visite dès la descente (perte virtuelle) ; le gain n'arrive qu'à
+// la remontée. Rend la profondeur atteinte dans l'arbre.
+static int playout(MctsTree& tree, Prng& rng, uint64_t& nodes) {
+    MctsArena& arena = *tree.arena;
+    Position pos = tree.root;
+    Player us = pos.sideToMove;
+    uint32_t path[MAX_PLY];
+    int length = 0;
+    uint32_t index = 0;
+    arena[0].visits.fetch_add(1, std::memory_order_relaxed);
+    path[length++] = 0;
+
+    int winner = -1;
+    for (;;) {
+        MctsNode& node = arena[index];
+        if (pos.counts[pos.sideToMove][EMPTY] == 0) {
+            winner = pos.sideToMove == PLAYER1 ? PLAYER2 : PLAYER1;
+            break;
+        }
+        uint32_t children = node.children.load(std::memory_order_acquire);
+        if (children == NODE_LEAF && node.visits.load(std::memory_order_relaxed) >= EXPAND_VISITS
+            && length < MAX_PLY && !arena.full()
+            && node.children.compare_exchange_strong(children, NODE_EXPANDING, std::memory_order_acquire)) {
+            children = expand(arena, node, pos);
+        }
+        if (children == NODE_LEAF || children == NODE_EXPANDING) {
+            break; // Feuille, ou enfants en cours de création par un autre thread
+        }
+        if (node.childCount == 0) {
+            winner = DRAW;
+            break;
+        }
+        index = select_child(arena, node, children);
+        MctsNode& child = arena[index];
+        child.visits.fetch_add(1, std::memory_order_relaxed);
+        apply_move(pos, child.move);
+        nodes++;
+        path[length++] = index;
+        if (length == MAX_PLY) {
+            break;
+        }
+    }
+    if (winner < 0) {
+        winner = rollout(pos, rng, nodes);
+    }
+
+    // Le noeud de profondeur d vient d'un coup de us si d est impair
+    Player them = us == PLAYER1 ? PLAYER2 : PLAYER1;
+    for (int d = 1; d < length; d++) {
+        Player mover = (d & 1) ? us : them;
+        uint32_t gain = winner == DRAW ? 1 : winner == mover ? 2 : 0;
+        if (gain > 0) {
+            arena[path[d]].reward.fetch_add(gain, std::memory_order_relaxed);
+        }
+    }
+    return length - 1;
+}
+
+// Boucle d'un thread ; le thread 0 surveille aussi l'horloge et l'arrêt externe
+static void run_thread(MctsTree* tree, int id, Clock::time_point deadline, bool checkTime,
+                       const std::atomic<bool>* externalStop, uint64_t* nodes, int* depth) {
+    Prng rng((tree->root.state.key ^ 0x9E3779B97F4A7C15ULL) * (2 * id + 1) | 1);
+    for (uint64_t n = 1; !tree->stop.load(std::memory_order_relaxed); n++) {
+        *depth = std::max(*depth, playout(*tree, rng, *nodes));
+        uint64_t total = tree->playouts.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (tree->playoutLimit != 0 && total >= tree->playoutLimit) {
+            tree->stop.store(true, std::memory_order_relaxed);
+        }
+        if (id == 0 && n % PLAYOUT_BATCH == 0
+            && ((checkTime && Clock::now() >= deadline)
+                || (externalStop != nullptr && externalStop->load(std::memory_order_relaxed)))) {
+            tree->stop.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+SearchResult mcts_search(const Position& position, const SearchLimits& limits) {
+    CHESS_TIMED(TIMER_SEARCH);
+    CHESS_COUNT(COUNTER_SEARCHES, 1);
+    auto start = Clock::now();
+    auto elapsed = [&start]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    SearchResult result;
+    int tbValue;
+    if (tb_root_move(position, result.bestMove, tbValue)) {
+        result.score = tb_score(tbValue, 0);
+        result.tbHits = 1;
+        CHESS_COUNT(COUNTER_TB_HITS, 1);
+        result.seconds = elapsed();
+        return result;
+    }
+
+    // Budget : le temps du coup entier (pas d'itération à finir), ou des simulations
+    double budget = 0;
+    Player us = position.sideToMove;
+    if (limits.movetime > 0) {
+        budget = limits.movetime / 1000.0;
+    } else if (limits.time[us] > 0) {
+        double remaining = limits.time[us] / 1000.0;
+        budget = std::min(remaining / 4, remaining / 30 + limits.increment[us] / 1000.0 * 3 / 4);
+    }
+
+    // Réserve de l'appelant, ou à défaut une réserve à la mesure du budget : chaque
+    // simulation crée au plus les enfants d'un noeud
+    uint64_t playoutLimit = limits.nodes != 0 || budget > 0 ? limits.nodes : MCTS_DEFAULT_PLAYOUTS;
+    std::unique_ptr<MctsArena> ownArena;
+    if (limits.arena == nullptr) {
+        uint64_t capacity = playoutLimit != 0 ? 1 + playoutLimit * MCTS_MAX_CHILDREN : MCTS_ARENA_NODES;
+        ownArena.reset(new MctsArena(static_cast<uint32_t>(std::min<uint64_t>(capacity, MCTS_ARENA_NODES))));
+    }
+    MctsArena& arena = limits.arena != nullptr ? *limits.arena : *ownArena;
+    arena.reset();
+    MctsTree tree;
+    tree.arena = &arena;
+    tree.root = position;
+    tree.playoutLimit = playoutLimit;
+    arena[arena.allocate(1)].init(MOVE_NONE);
+    MctsNode& root = arena[0];
+    if (position.counts[us][EMPTY] == 0 || expand(arena, root, position) == NODE_LEAF || root.childCount == 0) {
+        result.seconds = elapsed();
+        return result; // Partie finie : aucun coup à chercher
+    }
+
+    int threadCount = std::max(1, limits.threads);
+    std::vector<uint64_t> nodes(threadCount, 0);
+    std::vector<int> depths(threadCount, 0);
+    Clock::time_point deadline = start + std::chrono::microseconds(static_cast<int64_t>(budget * 1e6));
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; i++) {
+        helpers.emplace_back(run_thread, &tree, i, deadline, false, nullptr, &nodes[i], &depths[i]);
+    }
+    run_thread(&tree, 0, deadline, budget > 0, limits.stop, &nodes[0], &depths[0]);
+    for (std::thread& t : helpers) {
+        t.join();
+    }
+
+    // Coup joué : l'enfant le plus visité, plus sûr que le meilleur taux de gain
+    uint32_t first = root.children.load(std::memory_order_acquire);
+    uint32_t best = first;
+    for (uint32_t i = first; i < first + root.childCount; i++) {
+        if (arena[i].visits.load(std::memory_order_relaxed) > arena[best].visits.load(std::memory_order_relaxed)) {
+            best = i;
+        }
+    }
+    result.bestMove = arena[best].move;
+    // Score à la manière d'un écart Elo : 400 * log10(gains / pertes), borné
+    uint32_t visits = std::max(1u, arena[best].visits.load(std::memory_order_relaxed));
+    double rate = std::min(0.999, std::max(0.001, arena[best].reward.load(std::memory_order_relaxed) / (2.0 * visits)));
+    result.score = static_cast<int>(std::lround(400 * std::log10(rate / (1 - rate))));
+
+    result.seconds = elapsed();
+    result.playouts = tree.playouts.load(std::memory_order_relaxed);
+    for (int i = 0; i < threadCount; i++) {
+        result.nodes += nodes[i];
+        result.depth = std::max(result.depth, depths[i]);
+        result.threadNps.push_back(result.seconds > 0 ? nodes[i] / result.seconds : 0);
+    }
+    result.nps = result.seconds > 0 ? result.nodes / result.seconds : 0;
+    CHESS_COUNT(COUNTER_NODES, result.nodes);
+    CHESS_COUNT(COUNTER_PLAYOUTS, result.playouts);
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef CHESS_MCTS_H
+#define CHESS_MCTS_H
+
+#include <atomic>
+#include <memory>
+#include "search.h"
+
+// Recherche Monte-Carlo : sélection UCT, extension d'une feuille, partie simulée au
+// hasard jusqu'à la fin (ou jusqu'à MCTS_ROLLOUT_PLIES demi-coups, jugés alors sur le
+// matériel) et remontée du résultat. Dans cette variante, un camp peut perdre toutes
+// ses pièces en quelques coups : les simulations voient ces effondrements que
+// l'évaluation statique de l'alpha-bêta ne devine pas.
+//
+// Les threads partagent un seul arbre (parallélisme d'arbre) : chaque descente compte
+// d'avance une visite perdue (perte virtuelle) sur son chemin, ce qui écarte les autres
+// threads de la même branche jusqu'à la remontée du vrai résultat. Les noeuds viennent
+// d'une réserve (MctsArena) vidée à chaque coup : celle de limits.arena, gardée par
+// l'appelant d'une recherche à l'autre, ou à défaut une réserve propre à la recherche,
+// dimensionnée par son budget de simulations et libérée à la fin.
+
+#define MCTS_ARENA_NODES (1 << 21)   // Capacité maximale d'une réserve de noeuds (16 octets chacun)
+#define MCTS_MAX_CHILDREN 64         // Coups d'une position au plus (62 avec une pièce de chaque type)
+#define MCTS_ROLLOUT_PLIES 80        // Longueur maximale d'une simulation
+#define MCTS_DEFAULT_PLAYOUTS 10000  // Budget quand aucune limite n'est donnée
+
+struct MctsNode;
+
+// Réserve de noeuds d'un arbre : allouée à la construction (les pages ne sont touchées
+// qu'au fil des besoins), vidée d'un coup entre deux recherches. Les enfants d'un noeud
+// sont contigus, pris d'un seul fetch_add. Une réserve ne sert qu'à une recherche à la fois.
+class MctsArena {
+public:
+    explicit MctsArena(uint32_t capacity = MCTS_ARENA_NODES);
+    ~MctsArena();
+    MctsArena(const MctsArena&) = delete;
+    MctsArena& operator=(const MctsArena&) = delete;
+
+    uint32_t capacity() const { return size; }
+
+    void reset();
+    bool full() const;
+
+    // Indice du premier de n noeuds consécutifs, 0 (NODE_LEAF) si la réserve est pleine
+    uint32_t allocate(uint32_t n);
+
+    MctsNode& operator[](uint32_t index);
+
+private:
+    std::unique_ptr<MctsNode[]> nodes;
+    uint32_t size;
+    std::atomic<uint32_t> used{0};
+};
+
+// Chercher un coup par simulations. limits.nodes compte les simulations et
+// limits.depth est ignoré ; le temps et limits.stop s'appliquent comme pour search().
+// Le résultat donne le coup le plus visité, un score tiré de son taux de gain,
+// la profondeur de l'arbre, les positions jouées (nodes) et les simulations (playouts).
+SearchResult mcts_search(const Position& position, const SearchLimits& limits);
+
+#endif
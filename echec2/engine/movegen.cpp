@@ -0,0 +1,42 @@
+#include "movegen.h"
+#include "attacks.h"
+
+template <int N>
+void generate_moves(const BasicPosition<N>& pos, BasicMoveList<N>& list, GenType type) {
+    typedef BoardBitboard<N> Bits;
+    Player us = pos.sideToMove;
+    Player them = (us == PLAYER1) ? PLAYER2 : PLAYER1;
+    Bits occupied = pos.occupied[PLAYER1] | pos.occupied[PLAYER2];
+    Bits allowed = type == GEN_CAPTURES ? pos.occupied[them]
+                 : type == GEN_QUIETS   ? ~occupied
+                                        : ~pos.occupied[us];
+
+    Bits own = pos.occupied[us];
+    while (own) {
+        int from = pop_lsb(own);
+        Bits targets = board_attacks<N>(code_type(pos.squares[from]), from, occupied) & allowed;
+        while (targets) {
+            int to = pop_lsb(targets);
+            list.add(MoveCoding<N>::encode(from, to, code_type(pos.squares[to])));
+        }
+    }
+}
+
+// Tailles de plateau instanciées
+template void generate_moves<BOARD_SIZE>(const BasicPosition<BOARD_SIZE>&, BasicMoveList<BOARD_SIZE>&, GenType);
+template void generate_moves<10>(const BasicPosition<10>&, BasicMoveList<10>&, GenType);
+template void generate_moves<12>(const BasicPosition<12>&, BasicMoveList<12>&, GenType);
+
+bool is_pseudo_legal(const Position& pos, Move m) {
+    int from = move_from(m);
+    int to = move_to(m);
+    uint8_t code = pos.squares[from];
+    if (m == MOVE_NONE || code == 0 || code_player(code) != pos.sideToMove) {
+        return false;
+    }
+    if (code_type(pos.squares[to]) != move_captured(m)) {
+        return false; // Le type capturé fait partie du coup
+    }
+    Bitboard occupied = pos.occupied[PLAYER1] | pos.occupied[PLAYER2];
+    return (attacks_from(code_type(code), from, occupied) & ~pos.occupied[pos.sideToMove] & square_bb(to)) != 0;
+}
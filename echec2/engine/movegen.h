@@ -0,0 +1,31 @@
+#ifndef CHESS_MOVEGEN_H
+#define CHESS_MOVEGEN_H
+
+#include "position.h"
+
+// Liste de coups à capacité fixe, prévue pour vivre sur la pile. La marge de MAX_MOVES
+// croît avec le nombre de cases sur les plateaux plus grands.
+template <int N>
+struct BasicMoveList {
+    typedef typename MoveCoding<N>::Type MoveType;
+    MoveType moves[MAX_MOVES * ((N * N + 63) / 64)];
+    int size = 0;
+
+    void add(MoveType m) { moves[size++] = m; }
+    const MoveType* begin() const { return moves; }
+    const MoveType* end() const { return moves + size; }
+};
+typedef BasicMoveList<BOARD_SIZE> MoveList;
+
+// Étapes de génération : tout, captures seules ou coups tranquilles seuls
+enum GenType { GEN_ALL, GEN_CAPTURES, GEN_QUIETS };
+
+// Générer les coups du joueur au trait. Sans roi ni échec, tout coup
+// pseudo-légal est légal. Instancié pour les plateaux 8x8, 10x10 et 12x12.
+template <int N>
+void generate_moves(const BasicPosition<N>& pos, BasicMoveList<N>& list, GenType type = GEN_ALL);
+
+// Le coup (venu de la table de transposition ou d'un killer) est-il jouable ici ?
+bool is_pseudo_legal(const Position& pos, Move m);
+
+#endif
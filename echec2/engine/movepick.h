@@ -0,0 +1,126 @@
+#ifndef CHESS_MOVEPICK_H
+#define CHESS_MOVEPICK_H
+
+#include <utility>
+#include "movegen.h"
+
+// Table d'historique : bonus des coups tranquilles qui ont provoqué une coupure,
+// indexée par (joueur, départ, arrivée)
+typedef int16_t HistoryTable[2][SQUARE_COUNT][SQUARE_COUNT];
+#define HISTORY_MAX 16384
+
+// Ajuster une entrée d'historique ; le bonus diminue à l'approche de la borne
+inline void update_history(int16_t& entry, int bonus) {
+    entry += bonus - entry * (bonus < 0 ? -bonus : bonus) / HISTORY_MAX;
+}
+
+// Sélecteur de coups par étapes : coup de la table, captures triées MVV-LVA,
+// killers, puis coups tranquilles triés par historique. Les coups tranquilles
+// ne sont générés que si aucune coupure n'a eu lieu avant.
+class MovePicker {
+public:
+    // Recherche principale
+    MovePicker(const Position& p, Move tt, const Move* killerMoves, const HistoryTable* h)
+        : pos(p), ttMove(tt), history(h), stage(is_pseudo_legal(p, tt) ? STAGE_TT : STAGE_GEN_CAPTURES) {
+        killers[0] = killerMoves[0];
+        killers[1] = killerMoves[1];
+    }
+
+    // Quiescence : captures seulement
+    explicit MovePicker(const Position& p)
+        : pos(p), ttMove(MOVE_NONE), history(nullptr), stage(STAGE_GEN_CAPTURES), capturesOnly(true) {
+        killers[0] = killers[1] = MOVE_NONE;
+    }
+
+    // Coup suivant, MOVE_NONE quand il n'y en a plus
+    Move next() {
+        switch (stage) {
+            case STAGE_TT:
+                stage = STAGE_GEN_CAPTURES;
+                return ttMove;
+
+            case STAGE_GEN_CAPTURES:
+                generate_moves(pos, list, GEN_CAPTURES);
+                for (int i = 0; i < list.size; i++) {
+                    Move m = list.moves[i];
+                    // Victime la plus chère d'abord, puis attaquant le moins cher
+                    scores[i] = PieceValue[move_captured(m)] * 8 - PieceValue[code_type(pos.squares[move_from(m)])] / 10;
+                }
+                index = 0;
+                stage = STAGE_CAPTURES;
+                // fallthrough
+            case STAGE_CAPTURES:
+                while (index < list.size) {
+                    Move m = pick_best();
+                    if (m != ttMove) {
+                        return m;
+                    }
+                }
+                if (capturesOnly) {
+                    stage = STAGE_END;
+                    return MOVE_NONE;
+                }
+                stage = STAGE_KILLERS;
+                index = 0;
+                // fallthrough
+            case STAGE_KILLERS:
+                while (index < 2) {
+                    Move m = killers[index++];
+                    if (m != ttMove && m != MOVE_NONE && move_captured(m) == EMPTY && is_pseudo_legal(pos, m)) {
+                        return m;
+                    }
+                }
+                stage = STAGE_GEN_QUIETS;
+                // fallthrough
+            case STAGE_GEN_QUIETS:
+                list.size = 0;
+                generate_moves(pos, list, GEN_QUIETS);
+                for (int i = 0; i < list.size; i++) {
+                    Move m = list.moves[i];
+                    scores[i] = (*history)[pos.sideToMove][move_from(m)][move_to(m)];
+                }
+                index = 0;
+                stage = STAGE_QUIETS;
+                // fallthrough
+            case STAGE_QUIETS:
+                while (index < list.size) {
+                    Move m = pick_best();
+                    if (m != ttMove && m != killers[0] && m != killers[1]) {
+                        return m;
+                    }
+                }
+                stage = STAGE_END;
+                // fallthrough
+            default:
+                return MOVE_NONE;
+        }
+    }
+
+private:
+    enum Stage { STAGE_TT, STAGE_GEN_CAPTURES, STAGE_CAPTURES, STAGE_KILLERS, STAGE_GEN_QUIETS, STAGE_QUIETS, STAGE_END };
+
+    // Tri par sélection paresseux : on ne trie que ce qu'on consomme
+    Move pick_best() {
+        int best = index;
+        for (int i = index + 1; i < list.size; i++) {
+            if (scores[i] > scores[best]) {
+                best = i;
+            }
+        }
+        std::swap(list.moves[index], list.moves[best]);
+        std::swap(scores[index], scores[best]);
+        return list.moves[index++];
+    }
+
+    const Position& pos;
+    Move ttMove;
+    Move killers[2];
+    const HistoryTable* history;
+    Stage stage;
+    bool capturesOnly = false;
+    MoveList list;
+    int scores[MAX_MOVES];
+    int index = 0;
+};
+
+#endif
@@ -0,0 +1,304 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>     // Pour open
+#include <sys/mman.h>  // Pour mmap
+#include <sys/stat.h>
+#include <unistd.h>
+#include "nnue.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define HAS_NNUE_SIMD 1 // Noyaux AVX2 et SSE4.1, compilés chacun pour sa cible
+#endif
+
+static_assert(sizeof(NnueWeights) == 2 * NNUE_HIDDEN + 2 * NNUE_FEATURES * NNUE_HIDDEN + 4 * NNUE_HEAD
+                                   + 2 * NNUE_HEAD * 2 * NNUE_HIDDEN + 4 + 2 * NNUE_HEAD,
+              "NnueWeights doit suivre l'ordre du fichier, sans trou");
+
+// Les poids sont lus tels quels dans la projection : octets dans l'ordre du fichier,
+// et le bloc qui suit l'en-tête doit rester aligné pour les champs int32
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Le format du réseau est petit-boutiste");
+static_assert(NNUE_HEADER_SIZE % alignof(NnueWeights) == 0, "L'en-tête doit garder les poids alignés");
+
+static const char NNUE_MAGIC[8] = {'Q', 'N', 'R', 'B', 'N', 'N', '1', '\0'};
+
+// Réseau chargé : les poids pointent dans la projection du fichier
+static const NnueWeights* network = nullptr;
+static void* mapping = nullptr;
+static size_t mappingSize = 0;
+
+// Rangée nulle : retrait sans effet quand le coup ne prend rien
+static const int16_t zeroRow[NNUE_HIDDEN] = {};
+
+// Noyaux entiers d'un jeu d'instructions
+struct NnueKernels {
+    // out = in + add - sub - sub2 sur NNUE_HIDDEN valeurs, modulo 2^16
+    void (*update)(int16_t* out, const int16_t* in, const int16_t* add, const int16_t* sub, const int16_t* sub2);
+    // out = min(max(in, 0), 127) sur NNUE_HIDDEN valeurs
+    void (*clip)(int16_t* out, const int16_t* in);
+    // Produit de l'entrée écrêtée (2 * NNUE_HIDDEN valeurs) par chaque rangée de la couche dense
+    void (*head)(const int16_t* input, const NnueWeights& weights, int32_t* sums);
+};
+
+static void update_scalar(int16_t* out, const int16_t* in, const int16_t* add, const int16_t* sub, const int16_t* sub2) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        out[i] = static_cast<int16_t>(in[i] + add[i] - sub[i] - sub2[i]);
+    }
+}
+
+static void clip_scalar(int16_t* out, const int16_t* in) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) {
+        out[i] = in[i] < 0 ? 0 : in[i] > 127 ? 127 : in[i];
+    }
+}
+
+static void head_scalar(const int16_t* input, const NnueWeights& weights, int32_t* sums) {
+    for (int j = 0; j < NNUE_HEAD; j++) {
+        int32_t sum = 0;
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) {
+            sum += input[i] * weights.headWeights[j][i];
+        }
+        sums[j] = sum;
+    }
+}
+
+#ifdef HAS_NNUE_SIMD
+__attribute__((target("sse4.1")))
+static void update_sse4(int16_t* out, const int16_t* in, const int16_t* add, const int16_t* sub, const int16_t* sub2) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_add_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i)));
+        v = _mm_sub_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i)));
+        v = _mm_sub_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub2 + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void clip_sse4(int16_t* out, const int16_t* in) {
+    const __m128i low = _mm_setzero_si128(), high = _mm_set1_epi16(127);
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_min_epi16(_mm_max_epi16(v, low), high));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void head_sse4(const int16_t* input, const NnueWeights& weights, int32_t* sums) {
+    for (int j = 0; j < NNUE_HEAD; j++) {
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights.headWeights[j] + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(a, b));
+        }
+        sum = _mm_hadd_epi32(sum, sum);
+        sum = _mm_hadd_epi32(sum, sum);
+        sums[j] = _mm_cvtsi128_si32(sum);
+    }
+}
+
+__attribute__((target("avx2")))
+static void update_avx2(int16_t* out, const int16_t* in, const int16_t* add, const int16_t* sub, const int16_t* sub2) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(add + i)));
+        v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sub + i)));
+        v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sub2 + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+}
+
+__attribute__((target("avx2")))
+static void clip_avx2(int16_t* out, const int16_t* in) {
+    const __m256i low = _mm256_setzero_si256(), high = _mm256_set1_epi16(127);
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epi16(_mm256_max_epi16(v, low), high));
+    }
+}
+
+__attribute__((target("avx2")))
+static void head_avx2(const int16_t* input, const NnueWeights& weights, int32_t* sums) {
+    for (int j = 0; j < NNUE_HEAD; j++) {
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i += 16) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights.headWeights[j] + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, b));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_hadd_epi32(half, half);
+        half = _mm_hadd_epi32(half, half);
+        sums[j] = _mm_cvtsi128_si32(half);
+    }
+}
+#endif
+
+static const NnueKernels KERNELS[3] = {
+    {update_scalar, clip_scalar, head_scalar},
+#ifdef HAS_NNUE_SIMD
+    {update_sse4, clip_sse4, head_sse4},
+    {update_avx2, clip_avx2, head_avx2},
+#else
+    {update_scalar, clip_scalar, head_scalar},
+    {update_scalar, clip_scalar, head_scalar},
+#endif
+};
+
+static NnueSimd currentSimd = NNUE_SCALAR;
+static const NnueKernels* kernels = &KERNELS[NNUE_SCALAR];
+
+bool nnue_simd_supported(NnueSimd simd) {
+#ifdef HAS_NNUE_SIMD
+    if (simd == NNUE_AVX2) {
+        return __builtin_cpu_supports("avx2");
+    }
+    if (simd == NNUE_SSE4) {
+        return __builtin_cpu_supports("sse4.1");
+    }
+#endif
+    return simd == NNUE_SCALAR;
+}
+
+bool nnue_use_simd(NnueSimd simd) {
+    if (!nnue_simd_supported(simd)) {
+        return false;
+    }
+    currentSimd = simd;
+    kernels = &KERNELS[simd];
+    return true;
+}
+
+NnueSimd nnue_simd() {
+    return currentSimd;
+}
+
+const char* nnue_simd_name(NnueSimd simd) {
+    static const char* names[3] = {"scalaire", "SSE4.1", "AVX2"};
+    return names[simd];
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void write_u32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+bool nnue_load(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != NNUE_HEADER_SIZE + sizeof(NnueWeights)) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    const uint8_t* header = static_cast<const uint8_t*>(map);
+    if (memcmp(header, NNUE_MAGIC, sizeof(NNUE_MAGIC)) != 0 || read_u32(header + 8) != NNUE_VERSION
+        || read_u32(header + 12) != NNUE_FEATURES || read_u32(header + 16) != NNUE_HIDDEN
+        || read_u32(header + 20) != NNUE_HEAD
+        || reinterpret_cast<uintptr_t>(header + NNUE_HEADER_SIZE) % alignof(NnueWeights) != 0) {
+        munmap(map, size);
+        return false;
+    }
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+    mapping = map;
+    mappingSize = size;
+    network = reinterpret_cast<const NnueWeights*>(header + NNUE_HEADER_SIZE);
+
+    NnueSimd best = NNUE_AVX2;
+    while (!nnue_use_simd(best)) {
+        best = static_cast<NnueSimd>(best - 1);
+    }
+    return true;
+}
+
+bool nnue_enabled() {
+    return network != nullptr;
+}
+
+bool nnue_write(const char* filename, const NnueWeights& weights) {
+    uint8_t header[NNUE_HEADER_SIZE] = {};
+    memcpy(header, NNUE_MAGIC, sizeof(NNUE_MAGIC));
+    write_u32(header + 8, NNUE_VERSION);
+    write_u32(header + 12, NNUE_FEATURES);
+    write_u32(header + 16, NNUE_HIDDEN);
+    write_u32(header + 20, NNUE_HEAD);
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(&weights, sizeof(weights), 1, file) == 1;
+    return fclose(file) == 0 && ok;
+}
+
+// Rangée de poids d'une pièce vue par perspective : ses propres pièces d'abord,
+// cases tournées d'un demi-tour pour le joueur 2
+static const int16_t* feature_row(Player perspective, Player player, PieceType type, int square) {
+    int relative = player == perspective ? 0 : 1;
+    int s = perspective == PLAYER1 ? square : SQUARE_COUNT - 1 - square;
+    return network->featureWeights[(relative * 4 + type - 1) * SQUARE_COUNT + s];
+}
+
+void nnue_refresh(const Position& pos, NnueAccumulator& acc) {
+    for (int perspective = PLAYER1; perspective <= PLAYER2; perspective++) {
+        int16_t* values = acc.values[perspective];
+        memcpy(values, network->featureBias, sizeof(network->featureBias));
+        for (int player = PLAYER1; player <= PLAYER2; player++) {
+            for (int i = 0; i < pos.counts[player][EMPTY]; i++) {
+                int square = pos.pieceList[player][i];
+                const int16_t* row = feature_row(static_cast<Player>(perspective), static_cast<Player>(player),
+                                                 code_type(pos.squares[square]), square);
+                kernels->update(values, values, row, zeroRow, zeroRow);
+            }
+        }
+    }
+}
+
+void nnue_update(const NnueAccumulator& parent, NnueAccumulator& child, const Undo& undo) {
+    int from = move_from(undo.move), to = move_to(undo.move);
+    Player mover = undo.sideToMove;
+    PieceType type = code_type(undo.moved);
+    for (int p = PLAYER1; p <= PLAYER2; p++) {
+        Player perspective = static_cast<Player>(p);
+        const int16_t* captured = undo.captured != 0
+            ? feature_row(perspective, code_player(undo.captured), code_type(undo.captured), to) : zeroRow;
+        kernels->update(child.values[p], parent.values[p], feature_row(perspective, mover, type, to),
+                        feature_row(perspective, mover, type, from), captured);
+    }
+}
+
+int nnue_output(const NnueAccumulator& acc, Player sideToMove) {
+    alignas(32) int16_t input[2 * NNUE_HIDDEN];
+    kernels->clip(input, acc.values[sideToMove]);
+    kernels->clip(input + NNUE_HIDDEN, acc.values[sideToMove == PLAYER1 ? PLAYER2 : PLAYER1]);
+    int32_t sums[NNUE_HEAD];
+    kernels->head(input, *network, sums);
+    int32_t output = network->outputBias;
+    for (int j = 0; j < NNUE_HEAD; j++) {
+        int32_t hidden = (network->headBias[j] + sums[j]) >> NNUE_HEAD_SHIFT;
+        hidden = hidden < 0 ? 0 : hidden > 127 ? 127 : hidden;
+        output += hidden * network->outputWeights[j];
+    }
+    return output / NNUE_OUTPUT_SCALE;
+}
+
+int nnue_evaluate(const Position& pos) {
+    NnueAccumulator acc;
+    nnue_refresh(pos, acc);
+    return nnue_output(acc, pos.sideToMove);
+}
@@ -0,0 +1,92 @@
+#ifndef CHESS_NNUE_H
+#define CHESS_NNUE_H
+
+#include "position.h"
+
+// Évaluation neuronale à mise à jour incrémentale. Entrées : une caractéristique par
+// (camp relatif, type, case), vue de chaque joueur (le plateau tourné d'un demi-tour
+// pour le joueur 2). Couche de caractéristiques 512 -> 128 par perspective, tenue à
+// jour coup par coup dans un accumulateur d'entiers 16 bits ; puis les deux
+// perspectives écrêtées à [0, 127], celle du trait en tête, une couche dense 256 -> 32
+// et une sortie linéaire. Tout est entier : les noyaux AVX2, SSE4.1 et scalaires
+// donnent exactement le même score. Le réseau est lu par mmap (nnue_load) ; sans
+// réseau chargé, la recherche garde l'évaluation matérielle d'eval.h.
+
+#define NNUE_FEATURES (2 * 4 * SQUARE_COUNT)
+#define NNUE_HIDDEN 128
+#define NNUE_HEAD 32
+#define NNUE_HEAD_SHIFT 6     // Sommes de la couche dense ramenées à l'échelle des entrées
+#define NNUE_OUTPUT_SCALE 32  // Sortie divisée d'autant pour donner des centipions
+#define NNUE_VERSION 1
+#define NNUE_HEADER_SIZE 64
+
+// Poids dans l'ordre du fichier, juste après l'en-tête (petit-boutiste)
+struct NnueWeights {
+    int16_t featureBias[NNUE_HIDDEN];
+    int16_t featureWeights[NNUE_FEATURES][NNUE_HIDDEN];
+    int32_t headBias[NNUE_HEAD];
+    int16_t headWeights[NNUE_HEAD][2 * NNUE_HIDDEN];
+    int32_t outputBias;
+    int16_t outputWeights[NNUE_HEAD];
+};
+
+// Sorties de la couche de caractéristiques, une rangée par joueur
+struct alignas(32) NnueAccumulator {
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+// Jeux d'instructions des noyaux, du plus lent au plus rapide
+enum NnueSimd { NNUE_SCALAR, NNUE_SSE4, NNUE_AVX2 };
+
+// Projeter un réseau et choisir les meilleurs noyaux du CPU ; false si le fichier
+// est absent ou invalide (le réseau précédent reste alors en place)
+bool nnue_load(const char* filename);
+bool nnue_enabled();
+
+// Écrire un réseau (pour chess_nnuegen) ; false en cas d'erreur
+bool nnue_write(const char* filename, const NnueWeights& weights);
+
+// Noyaux utilisés : le meilleur jeu disponible par défaut. nnue_use_simd rend false
+// si le CPU ne l'a pas ; sert à comparer les chemins.
+bool nnue_simd_supported(NnueSimd simd);
+bool nnue_use_simd(NnueSimd simd);
+NnueSimd nnue_simd();
+const char* nnue_simd_name(NnueSimd simd);
+
+// Accumulateur calculé depuis toutes les pièces de la position
+void nnue_refresh(const Position& pos, NnueAccumulator& acc);
+
+// Accumulateur après le coup décrit par undo, depuis celui d'avant le coup
+void nnue_update(const NnueAccumulator& parent, NnueAccumulator& child, const Undo& undo);
+
+// Score du point de vue de sideToMove
+int nnue_output(const NnueAccumulator& acc, Player sideToMove);
+
+// Évaluation complète, sans accumulateur gardé
+int nnue_evaluate(const Position& pos);
+
+// Accumulateurs d'une recherche, un par entrée de l'UndoStack : l'entrée p est celle de
+// la position après p coups depuis la racine. Ils ne sont calculés qu'à l'évaluation,
+// depuis le dernier à jour ; pushed() doit suivre chaque do_move.
+struct NnueStack {
+    NnueAccumulator entries[MAX_PLY + 1];
+    int valid = 0; // Entrées à jour, depuis la racine
+
+    void reset(const Position& root) {
+        nnue_refresh(root, entries[0]);
+        valid = 1;
+    }
+
+    void pushed(int size) {
+        valid = valid < size ? valid : size;
+    }
+
+    int evaluate(const Position& pos, const UndoStack& stack) {
+        for (; valid <= stack.size; valid++) {
+            nnue_update(entries[valid - 1], entries[valid], stack.entries[valid - 1]);
+        }
+        return nnue_output(entries[stack.size], pos.sideToMove);
+    }
+};
+
+#endif
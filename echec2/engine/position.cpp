@@ -0,0 +1,197 @@
+#include <iostream>
+#include <cstring>  // Pour memset
+#include "position.h"
+#include "attacks.h"
+
+template <int N>
+static void init_zobrist_keys(uint64_t seed) {
+    Prng rng(seed);
+    for (int player = 0; player < 2; player++) {
+        for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+            for (int square = 0; square < N * N; square++) {
+                Zobrist<N>.piece[player][type][square] = rng.next();
+            }
+        }
+    }
+    Zobrist<N>.side = rng.next();
+}
+
+void init_zobrist() {
+    init_zobrist_keys<BOARD_SIZE>(1070372); // Graine d'origine : clés des livres et tables inchangées
+    init_zobrist_keys<10>(1070373);
+    init_zobrist_keys<12>(1070374);
+}
+
+// Vider la position
+template <int N>
+void clear_position(BasicPosition<N>* pos) {
+    memset(pos, 0, sizeof(BasicPosition<N>));
+    pos->sideToMove = PLAYER1;
+}
+
+bool position_is_consistent(const Position* pos) {
+    Position fresh;
+    clear_position(&fresh);
+    for (int square = 0; square < SQUARE_COUNT; square++) {
+        uint8_t code = pos->squares[square];
+        if (code != 0) {
+            put_piece(&fresh, square, code_type(code), code_player(code));
+        }
+    }
+    set_side_to_move(&fresh, pos->sideToMove);
+
+    if (memcmp(fresh.pieces, pos->pieces, sizeof(pos->pieces)) != 0
+        || memcmp(fresh.occupied, pos->occupied, sizeof(pos->occupied)) != 0
+        || memcmp(fresh.counts, pos->counts, sizeof(pos->counts)) != 0
+        || fresh.state.key != pos->state.key) {
+        return false;
+    }
+    for (int player = 0; player < 2; player++) {
+        if (fresh.state.material[player] != pos->state.material[player] || fresh.state.pst[player] != pos->state.pst[player]) {
+            return false;
+        }
+        // L'ordre des listes dépend de l'historique des coups : on vérifie seulement l'appariement
+        for (int i = 0; i < pos->counts[player][EMPTY]; i++) {
+            int square = pos->pieceList[player][i];
+            if (pos->squares[square] == 0 || code_player(pos->squares[square]) != player || pos->pieceIndex[square] != i) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Fonction pour initialiser le plateau
+template <int N>
+void initialize_board(BasicPosition<N>* pos) {
+    clear_position(pos); // Toutes les cases sont vides au départ
+
+    // Placement des pièces : première rangée du joueur 1, dernière du joueur 2, en miroir
+    const PieceType order[4] = {ROOK, KNIGHT, BISHOP, QUEEN};
+    for (int i = 0; i < 4; i++) {
+        put_piece(pos, i, order[i], PLAYER1);
+    }
+    for (int i = 0; i < 4; i++) {
+        put_piece(pos, N * N - 1 - i, order[i], PLAYER2);
+    }
+}
+
+// Tailles de plateau instanciées
+template void clear_position<BOARD_SIZE>(BasicPosition<BOARD_SIZE>* pos);
+template void clear_position<10>(BasicPosition<10>* pos);
+template void clear_position<12>(BasicPosition<12>* pos);
+template void initialize_board<BOARD_SIZE>(BasicPosition<BOARD_SIZE>* pos);
+template void initialize_board<10>(BasicPosition<10>* pos);
+template void initialize_board<12>(BasicPosition<12>* pos);
+
+// Fonction pour afficher le plateau dans la console
+void print_board(const Position* pos) {
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            uint8_t code = pos->squares[square_of(x, y)];
+            if (code != 0) {
+                std::cout << (code_type(code) + 1) << " "; // Afficher le type de pièce
+            } else {
+                std::cout << "0 "; // Afficher 0 pour une case vide
+            }
+        }
+        std::cout << std::endl; // Nouvelle ligne pour chaque rangée
+    }
+}
+
+// Vérifier si un mouvement est valide : la pièce ne saute pas par-dessus les autres
+// et ne prend pas une pièce de son propre camp
+int is_valid_move(const Position* pos, int fromX, int fromY, int toX, int toY) {
+    if (!on_board(fromX, fromY) || !on_board(toX, toY)) {
+        return 0; // Hors du plateau
+    }
+    int from = square_of(fromX, fromY);
+    uint8_t code = pos->squares[from];
+    if (code == 0) {
+        return 0; // Aucune pièce à déplacer
+    }
+    Player player = code_player(code);
+    Bitboard occupied = pos->occupied[PLAYER1] | pos->occupied[PLAYER2];
+    Bitboard targets = attacks_from(code_type(code), from, occupied) & ~pos->occupied[player];
+    return (targets & square_bb(square_of(toX, toY))) != 0;
+}
+
+
+// Lettre de chaque type de pièce, indexée par PieceType
+static const char PieceLetters[PIECE_TYPE_COUNT + 1] = ".QNRB";
+
+bool position_from_text(Position* pos, const char* text) {
+    clear_position(pos);
+    int x = 0, y = 0;
+    const char* c = text;
+    for (; *c != '\0' && *c != ' '; c++) {
+        if (*c == '/') {
+            if (x != BOARD_SIZE) {
+                return false;
+            }
+            x = 0;
+            y++;
+        } else if (*c >= '1' && *c <= '8') {
+            x += *c - '0';
+        } else {
+            const char* letter = strchr(PieceLetters + 1, *c >= 'a' ? *c - 'a' + 'A' : *c);
+            Player player = *c >= 'a' ? PLAYER2 : PLAYER1;
+            if (letter == nullptr || x >= BOARD_SIZE || y >= BOARD_SIZE || pos->counts[player][EMPTY] >= MAX_PIECES) {
+                return false;
+            }
+            put_piece(pos, square_of(x, y), static_cast<PieceType>(letter - PieceLetters), player);
+            x++;
+        }
+        if (x > BOARD_SIZE) {
+            return false;
+        }
+    }
+    if (y != BOARD_SIZE - 1 || x != BOARD_SIZE) {
+        return false;
+    }
+    while (*c == ' ') {
+        c++;
+    }
+    if (*c == '2') {
+        set_side_to_move(pos, PLAYER2);
+    } else if (*c != '1') {
+        return false;
+    }
+    return true;
+}
+
+std::string position_to_text(const Position* pos) {
+    std::string text;
+    for (int y = 0; y < BOARD_SIZE; y++) {
+        int empty = 0;
+        for (int x = 0; x < BOARD_SIZE; x++) {
+            uint8_t code = pos->squares[square_of(x, y)];
+            if (code == 0) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) {
+                text += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            char letter = PieceLetters[code_type(code)];
+            text += code_player(code) == PLAYER1 ? letter : static_cast<char>(letter - 'A' + 'a');
+        }
+        if (empty > 0) {
+            text += static_cast<char>('0' + empty);
+        }
+        if (y < BOARD_SIZE - 1) {
+            text += '/';
+        }
+    }
+    text += pos->sideToMove == PLAYER1 ? " 1" : " 2";
+    return text;
+}
+
+std::string move_to_text(Move m) {
+    char text[5] = {
+        static_cast<char>('a' + square_x(move_from(m))), static_cast<char>('1' + square_y(move_from(m))),
+        static_cast<char>('a' + square_x(move_to(m))), static_cast<char>('1' + square_y(move_to(m))), '\0'
+    };
+    return text;
+}
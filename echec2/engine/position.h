@@ -0,0 +1,230 @@
+#ifndef CHESS_POSITION_H
+#define CHESS_POSITION_H
+
+#include <string>
+#include <type_traits>
+#include "bitboard.h"
+
+// Clés de Zobrist d'un plateau N x N : une valeur aléatoire par (joueur, type, case)
+// et une pour le trait
+template <int N>
+struct ZobristKeys {
+    uint64_t piece[2][PIECE_TYPE_COUNT][N * N];
+    uint64_t side;
+};
+template <int N>
+inline ZobristKeys<N> Zobrist;
+
+// Tirer les clés de Zobrist de chaque taille de plateau (à appeler une fois au démarrage)
+void init_zobrist();
+
+// Valeur matérielle de chaque type de pièce, indexée par PieceType
+const int PieceValue[PIECE_TYPE_COUNT] = {0, 900, 320, 500, 330};
+
+// Table pièce-case : sans pions ni roi, seul compte l'éloignement du centre, avec un
+// poids par type (le cavalier y est le plus sensible). Le plateau étant symétrique,
+// la même table sert aux deux joueurs.
+template <int N>
+struct PieceSquareTable {
+    int16_t values[PIECE_TYPE_COUNT][N * N];
+
+    constexpr PieceSquareTable() : values() {
+        const int weights[PIECE_TYPE_COUNT] = {0, 4, 10, 2, 6};
+        for (int square = 0; square < N * N; square++) {
+            int dx = 2 * (square % N) - (N - 1);
+            int dy = 2 * (square / N) - (N - 1);
+            int ring = ((dx < 0 ? -dx : dx) > (dy < 0 ? -dy : dy) ? (dx < 0 ? -dx : dx) : (dy < 0 ? -dy : dy)) / 2;
+            for (int type = 0; type < PIECE_TYPE_COUNT; type++) {
+                values[type][square] = static_cast<int16_t>(weights[type] * (N / 2 - 1 - ring));
+            }
+        }
+    }
+};
+template <int N>
+inline constexpr PieceSquareTable<N> PieceSquareTables{};
+inline constexpr const PieceSquareTable<BOARD_SIZE>& PieceSquare = PieceSquareTables<BOARD_SIZE>;
+
+// Nombre maximal de pièces par joueur dans une position (taille des listes de pièces)
+#define MAX_PIECES 16
+
+// État tenu à jour de façon incrémentale à chaque pose ou retrait de pièce
+struct PositionState {
+    uint64_t key;               // Clé de Zobrist de la position
+    int16_t material[2];        // Somme des valeurs des pièces de chaque joueur
+    int16_t pst[2];             // Somme des valeurs pièce-case de chaque joueur
+    uint16_t pliesSinceCapture; // Aucune répétition possible au-delà de la dernière prise
+};
+
+// Structure pour représenter une position sur un plateau N x N : type valeur, copiable
+// par memcpy. Le jeu utilise Position (8x8) ; les tailles 10 et 12 sont instanciées
+// pour les variantes.
+template <int N>
+struct BasicPosition {
+    static_assert(N >= 4 && N <= 15, "Les cases doivent tenir sur un octet");
+    typedef BoardBitboard<N> Bits;
+
+    Bits pieces[2][PIECE_TYPE_COUNT];    // Un masque d'occupation par (joueur, type) ; l'indice EMPTY reste vide
+    Bits occupied[2];                    // Union des masques de chaque joueur
+    uint8_t squares[N * N];              // Mailbox : accès en O(1) au contenu d'une case
+    uint8_t counts[2][PIECE_TYPE_COUNT]; // Nombre de pièces par (joueur, type) ; l'indice EMPTY contient le total
+    uint8_t pieceList[2][MAX_PIECES];    // Cases occupées par chaque joueur, les counts[p][EMPTY] premières sont valides
+    uint8_t pieceIndex[N * N];           // Rang de la pièce d'une case dans la liste de son joueur
+    Player sideToMove;
+    PositionState state;
+};
+typedef BasicPosition<BOARD_SIZE> Position;
+static_assert(std::is_trivially_copyable<Position>::value, "Position doit rester copiable par memcpy");
+
+// Poser une pièce sur une case vide
+template <int N>
+inline void put_piece(BasicPosition<N>* pos, int square, PieceType type, Player player) {
+    BoardBitboard<N> b = square_bit<N>(square);
+    pos->pieces[player][type] |= b;
+    pos->occupied[player] |= b;
+    pos->squares[square] = piece_code(type, player);
+    pos->pieceIndex[square] = pos->counts[player][EMPTY];
+    pos->pieceList[player][pos->counts[player][EMPTY]] = static_cast<uint8_t>(square);
+    pos->counts[player][type]++;
+    pos->counts[player][EMPTY]++;
+    pos->state.material[player] += PieceValue[type];
+    pos->state.pst[player] += PieceSquareTables<N>.values[type][square];
+    pos->state.key ^= Zobrist<N>.piece[player][type][square];
+}
+
+// Retirer la pièce d'une case occupée
+template <int N>
+inline void remove_piece(BasicPosition<N>* pos, int square) {
+    uint8_t code = pos->squares[square];
+    PieceType type = code_type(code);
+    Player player = code_player(code);
+    BoardBitboard<N> b = square_bit<N>(square);
+    pos->pieces[player][type] ^= b;
+    pos->occupied[player] ^= b;
+    pos->squares[square] = 0;
+    // La dernière pièce de la liste prend la place de celle qu'on retire
+    uint8_t last = pos->pieceList[player][pos->counts[player][EMPTY] - 1];
+    pos->pieceList[player][pos->pieceIndex[square]] = last;
+    pos->pieceIndex[last] = pos->pieceIndex[square];
+    pos->counts[player][type]--;
+    pos->counts[player][EMPTY]--;
+    pos->state.material[player] -= PieceValue[type];
+    pos->state.pst[player] -= PieceSquareTables<N>.values[type][square];
+    pos->state.key ^= Zobrist<N>.piece[player][type][square];
+}
+
+// Déplacer une pièce vers une case vide
+template <int N>
+inline void move_piece(BasicPosition<N>* pos, int from, int to) {
+    uint8_t code = pos->squares[from];
+    PieceType type = code_type(code);
+    Player player = code_player(code);
+    BoardBitboard<N> fromTo = square_bit<N>(from) | square_bit<N>(to);
+    pos->pieces[player][type] ^= fromTo;
+    pos->occupied[player] ^= fromTo;
+    pos->squares[from] = 0;
+    pos->squares[to] = code;
+    pos->pieceIndex[to] = pos->pieceIndex[from];
+    pos->pieceList[player][pos->pieceIndex[to]] = static_cast<uint8_t>(to);
+    pos->state.pst[player] += PieceSquareTables<N>.values[type][to] - PieceSquareTables<N>.values[type][from];
+    pos->state.key ^= Zobrist<N>.piece[player][type][from] ^ Zobrist<N>.piece[player][type][to];
+}
+
+// Changer le joueur au trait en gardant la clé cohérente
+template <int N>
+inline void set_side_to_move(BasicPosition<N>* pos, Player player) {
+    if (pos->sideToMove != player) {
+        pos->state.key ^= Zobrist<N>.side;
+    }
+    pos->sideToMove = player;
+}
+
+// Ce qu'il faut pour annuler un coup sans recalculer quoi que ce soit
+template <int N>
+struct BasicUndo {
+    typename MoveCoding<N>::Type move;
+    uint8_t captured;    // Code mailbox de la pièce prise, 0 si aucune
+    uint8_t moved;       // Code mailbox de la pièce jouée (pour les mises à jour de nnue.h)
+    Player sideToMove;   // Joueur au trait avant le coup
+    PositionState state; // Accumulateurs incrémentaux avant le coup
+};
+typedef BasicUndo<BOARD_SIZE> Undo;
+
+// Pile d'annulation à profondeur fixe : aucune allocation pendant une recherche
+template <int N>
+struct BasicUndoStack {
+    BasicUndo<N> entries[MAX_PLY];
+    int size = 0;
+};
+typedef BasicUndoStack<BOARD_SIZE> UndoStack;
+
+// Appliquer un coup déjà validé, sans rien mémoriser
+template <int N>
+inline void apply_move(BasicPosition<N>& pos, typename MoveCoding<N>::Type m) {
+    int to = MoveCoding<N>::to(m);
+    if (pos.squares[to] != 0) {
+        remove_piece(&pos, to);
+        pos.state.pliesSinceCapture = 0;
+    } else {
+        pos.state.pliesSinceCapture++;
+    }
+    move_piece(&pos, MoveCoding<N>::from(m), to);
+    pos.sideToMove = (pos.sideToMove == PLAYER1) ? PLAYER2 : PLAYER1;
+    pos.state.key ^= Zobrist<N>.side;
+}
+
+// Jouer un coup en empilant de quoi l'annuler
+template <int N>
+inline void do_move(BasicPosition<N>& pos, typename MoveCoding<N>::Type m, BasicUndoStack<N>& stack) {
+    BasicUndo<N>& undo = stack.entries[stack.size++];
+    undo.move = m;
+    undo.captured = pos.squares[MoveCoding<N>::to(m)];
+    undo.moved = pos.squares[MoveCoding<N>::from(m)];
+    undo.sideToMove = pos.sideToMove;
+    undo.state = pos.state;
+    apply_move(pos, m);
+}
+
+// Annuler le dernier coup joué avec do_move
+template <int N>
+inline void undo_move(BasicPosition<N>& pos, BasicUndoStack<N>& stack) {
+    const BasicUndo<N>& undo = stack.entries[--stack.size];
+    int from = MoveCoding<N>::from(undo.move);
+    int to = MoveCoding<N>::to(undo.move);
+    move_piece(&pos, to, from);
+    if (undo.captured != 0) {
+        put_piece(&pos, to, code_type(undo.captured), code_player(undo.captured));
+    }
+    pos.sideToMove = undo.sideToMove;
+    pos.state = undo.state;
+}
+
+// Vider la position
+template <int N>
+void clear_position(BasicPosition<N>* pos);
+
+// Tout recalculer depuis la mailbox (bitboards, compteurs, listes, accumulateurs, clé)
+// et comparer à l'état incrémental ; sert aux vérifications en mode debug
+bool position_is_consistent(const Position* pos);
+
+// Fonction pour initialiser le plateau : tour, cavalier, fou et dame de chaque joueur
+// dans des coins opposés, quelle que soit la taille
+template <int N>
+void initialize_board(BasicPosition<N>* pos);
+
+// Fonction pour afficher le plateau dans la console
+void print_board(const Position* pos);
+
+// Vérifier si un mouvement est valide : la pièce ne saute pas par-dessus les autres
+// et ne prend pas une pièce de son propre camp
+int is_valid_move(const Position* pos, int fromX, int fromY, int toX, int toY);
+
+// Notation texte d'une position : les rangées y = 0 à 7 séparées par '/', un chiffre
+// par suite de cases vides, QNRB pour le joueur 1 et qnrb pour le joueur 2, puis le
+// joueur au trait (1 ou 2). Position de départ : "RNBQ4/8/8/8/8/8/8/4qbnr 1"
+bool position_from_text(Position* pos, const char* text);
+std::string position_to_text(const Position* pos);
+
+// Notation d'un coup : colonnes a-h pour x, rangées 1-8 pour y, par exemple "a1a2"
+std::string move_to_text(Move m);
+
+#endif
@@ -0,0 +1,410 @@
+#include <atomic>
+#include <chrono>   // Pour mesurer la durée de la recherche
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include "search.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "tt.h"
+#include "tablebase.h"
+#include "instrument.h"
+#include "mcts.h"
+#include "nnue.h"
+#include "book.h"
+
+// Nombre de noeuds entre deux publications du compteur partagé et deux lectures de l'horloge
+#define NODE_BATCH 256
+
+typedef std::chrono::steady_clock Clock;
+
+// Statistiques détaillées de la recherche, absentes sans instrumentation
+#ifdef CHESS_INSTRUMENT
+#define SEARCH_STAT(x) (x)
+#else
+#define SEARCH_STAT(x) ((void)0)
+#endif
+
+// État de travail d'un thread de recherche : une position qu'on joue et déjoue en place
+struct Searcher {
+    Position pos;
+    UndoStack stack;
+    const std::vector<uint64_t>* history = nullptr; // Clés des positions de la partie avant la racine
+    uint64_t nodes = 0;
+    uint64_t tbHits = 0;                            // Positions résolues par les tables de finales
+    uint64_t nodeLimit = 0;
+    std::atomic<bool>* stopFlag = nullptr;          // Partagé par tous les threads
+    std::atomic<uint64_t>* sharedNodes = nullptr;   // Total publié par tous les threads
+    bool checkTime = false;                         // Seul le thread principal regarde l'horloge
+    Clock::time_point deadline;                     // Limite dure du coup
+    const std::atomic<bool>* externalStop = nullptr; // Lu par le thread principal avec l'horloge
+    uint64_t qnodes = 0, ttProbes = 0, ttHits = 0;  // Avec SEARCH_STAT seulement
+    uint64_t cutoffs = 0, firstMoveCutoffs = 0;
+
+    Move killers[MAX_PLY][2] = {};    // Coups tranquilles ayant coupé à chaque ply
+    HistoryTable quietHistory = {};   // Historique des coups tranquilles
+    bool useNnue = false;             // Évaluation neuronale, avec ses accumulateurs
+    NnueStack nnue;
+
+    void play(Move m) {
+        do_move(pos, m, stack);
+        nnue.pushed(stack.size);
+    }
+
+    bool stopped() const { return stopFlag->load(std::memory_order_relaxed); }
+
+    // Compter un noeud ; le budget global est vérifié par paquets pour éviter le trafic atomique
+    bool out_of_budget() {
+        if ((++nodes % NODE_BATCH) == 0) {
+            uint64_t total = sharedNodes->fetch_add(NODE_BATCH, std::memory_order_relaxed) + NODE_BATCH;
+            if ((nodeLimit != 0 && total >= nodeLimit) || (checkTime && Clock::now() >= deadline)
+                || (externalStop != nullptr && externalStop->load(std::memory_order_relaxed))) {
+                stopFlag->store(true, std::memory_order_relaxed);
+            }
+        }
+        return stopped();
+    }
+
+    // La position courante est-elle déjà apparue depuis la dernière prise ?
+    // Dans l'arbre, une seule répétition suffit pour compter la nulle.
+    bool is_repetition() const {
+        int limit = pos.state.pliesSinceCapture;
+        int gameSize = history ? static_cast<int>(history->size()) : 0;
+        for (int back = 2; back <= limit; back += 2) {
+            uint64_t key;
+            if (back <= stack.size) {
+                key = stack.entries[stack.size - back].state.key;
+            } else if (back - stack.size <= gameSize) {
+                key = (*history)[gameSize - (back - stack.size)];
+            } else {
+                break;
+            }
+            if (key == pos.state.key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Recherche de quiescence : seulement les captures, jusqu'à une position calme
+    int quiescence(int alpha, int beta, int ply) {
+        if (out_of_budget()) {
+            return 0;
+        }
+        SEARCH_STAT(qnodes++);
+        if (pos.counts[pos.sideToMove][EMPTY] == 0) {
+            return -SCORE_WIN + ply; // Toutes nos pièces ont été prises
+        }
+        int standPat = useNnue ? nnue.evaluate(pos, stack) : evaluate(pos);
+        if (standPat >= beta || ply >= MAX_PLY - 1) {
+            return standPat;
+        }
+        if (standPat > alpha) {
+            alpha = standPat;
+        }
+
+        MovePicker picker(pos);
+        for (Move m = picker.next(); m != MOVE_NONE; m = picker.next()) {
+            play(m);
+            int score = -quiescence(-beta, -alpha, ply + 1);
+            undo_move(pos, stack);
+            if (stopped()) {
+                return 0;
+            }
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+        return alpha;
+    }
+
+    // Negamax alpha-bêta avec recherche à fenêtre nulle (PVS) après le premier coup
+    int negamax(int alpha, int beta, int depth, int ply) {
+        if (pos.counts[pos.sideToMove][EMPTY] == 0) {
+            return -SCORE_WIN + ply;
+        }
+        if (ply > 0 && is_repetition()) {
+            return 0;
+        }
+        // Peu de pièces : la table de finales donne la valeur exacte
+        int tbValue;
+        if (ply > 0 && tb_probe(pos, tbValue)) {
+            tbHits++;
+            return tb_score(tbValue, ply);
+        }
+        if (depth <= 0) {
+            return quiescence(alpha, beta, ply);
+        }
+        if (out_of_budget()) {
+            return 0;
+        }
+
+        // Coupure par la table de transposition, hors fenêtre principale
+        bool pvNode = beta - alpha > 1;
+        TTData tt;
+        Move ttMove = MOVE_NONE;
+        bool ttHit = TT.probe(pos.state.key, tt);
+        SEARCH_STAT(ttProbes++);
+        SEARCH_STAT(ttHits += ttHit);
+        if (ttHit) {
+            ttMove = tt.move;
+        }
+        if (ttHit && !pvNode && tt.depth >= depth) {
+            int ttScore = score_from_tt(tt.score, ply);
+            if (tt.bound == BOUND_EXACT
+                || (tt.bound == BOUND_LOWER && ttScore >= beta)
+                || (tt.bound == BOUND_UPPER && ttScore <= alpha)) {
+                return ttScore;
+            }
+        }
+
+        MovePicker picker(pos, ttMove, killers[ply], &quietHistory);
+        MoveList quietsTried; // Pour pénaliser les coups tranquilles qui n'ont pas coupé
+        int originalAlpha = alpha;
+        Move bestMove = MOVE_NONE;
+        int moveCount = 0;
+        for (Move m = picker.next(); m != MOVE_NONE; m = picker.next()) {
+            play(m);
+            int score;
+            if (moveCount == 0) {
+                score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+            } else {
+                score = -negamax(-alpha - 1, -alpha, depth - 1, ply + 1);
+                if (score > alpha && score < beta) {
+                    score = -negamax(-beta, -alpha, depth - 1, ply + 1);
+                }
+            }
+            undo_move(pos, stack);
+            if (stopped()) {
+                return 0;
+            }
+            moveCount++;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = m;
+                if (alpha >= beta) {
+                    SEARCH_STAT(cutoffs++);
+                    SEARCH_STAT(firstMoveCutoffs += moveCount == 1);
+                    if (move_captured(m) == EMPTY) {
+                        update_quiet_stats(m, quietsTried, depth, ply);
+                    }
+                    break;
+                }
+            }
+            if (move_captured(m) == EMPTY) {
+                quietsTried.add(m);
+            }
+        }
+        if (moveCount == 0) {
+            return 0; // Plus aucun coup possible : partie nulle
+        }
+
+        Bound bound = alpha >= beta ? BOUND_LOWER : alpha > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+        TT.store(pos.state.key, depth, bound, score_to_tt(alpha, ply), bestMove);
+        return alpha;
+    }
+
+    // Un coup tranquille a coupé : il devient killer et gagne en historique,
+    // les coups tranquilles essayés avant lui perdent d'autant
+    void update_quiet_stats(Move m, const MoveList& quietsTried, int depth, int ply) {
+        if (killers[ply][0] != m) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = m;
+        }
+        int bonus = std::min(depth * depth, 1200);
+        Player us = pos.sideToMove;
+        update_history(quietHistory[us][move_from(m)][move_to(m)], bonus);
+        for (Move q : quietsTried) {
+            update_history(quietHistory[us][move_from(q)][move_to(q)], -bonus);
+        }
+    }
+
+    // Une itération à la racine : le meilleur coup est ramené en tête de liste.
+    // Retourne false si la recherche a été interrompue avant la fin.
+    bool search_root(MoveList& rootMoves, int depth, int& bestScore) {
+        int alpha = -SCORE_INFINITE;
+        int bestIndex = -1;
+        for (int i = 0; i < rootMoves.size; i++) {
+            play(rootMoves.moves[i]);
+            int score;
+            if (bestIndex < 0) {
+                score = -negamax(-SCORE_INFINITE, -alpha, depth - 1, 1);
+            } else {
+                score = -negamax(-alpha - 1, -alpha, depth - 1, 1);
+                if (score > alpha) {
+                    score = -negamax(-SCORE_INFINITE, -alpha, depth - 1, 1);
+                }
+            }
+            undo_move(pos, stack);
+            if (stopped()) {
+                return false;
+            }
+            if (score > alpha) {
+                alpha = score;
+                bestIndex = i;
+            }
+        }
+        std::swap(rootMoves.moves[0], rootMoves.moves[bestIndex]);
+        bestScore = alpha;
+        TT.store(pos.state.key, depth, BOUND_EXACT, alpha, rootMoves.moves[0]);
+        return true;
+    }
+};
+
+// Boucle d'un thread assistant : approfondissement sans fin jusqu'au signal d'arrêt.
+// Les threads impairs ont une itération d'avance pour que tous ne cherchent pas
+// la même profondeur ; ils se partagent leur travail par la table de transposition.
+static void helper_thread(Searcher* searcher, int id) {
+    MoveList rootMoves;
+    generate_moves(searcher->pos, rootMoves);
+    if (rootMoves.size == 0) {
+        return;
+    }
+    std::rotate(rootMoves.moves, rootMoves.moves + id % rootMoves.size, rootMoves.moves + rootMoves.size);
+    for (int depth = 1 + (id & 1); depth < MAX_PLY && !searcher->stopped(); depth++) {
+        int score;
+        searcher->search_root(rootMoves, depth, score);
+    }
+}
+
+// Chercher le meilleur coup pour le joueur au trait (approfondissement itératif,
+// avec threads assistants Lazy SMP si limits.threads > 1)
+SearchResult search(const Position& position, const SearchLimits& limits, const std::vector<uint64_t>* history) {
+    // Position du livre d'ouverture : le coup est joué aussitôt, pour les deux moteurs
+    Move bookMove;
+    if (limits.book && book_move(position, bookMove)) {
+        SearchResult result;
+        result.bestMove = bookMove;
+        result.bookMove = true;
+        CHESS_COUNT(COUNTER_BOOK_HITS, 1);
+        return result;
+    }
+    if (limits.engine == ENGINE_MCTS) {
+        return mcts_search(position, limits);
+    }
+    CHESS_TIMED(TIMER_SEARCH);
+    CHESS_COUNT(COUNTER_SEARCHES, 1);
+    auto start = Clock::now();
+    auto elapsed = [&start]() { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    // Position couverte par les tables de finales : le coup est connu sans chercher
+    SearchResult result;
+    int tbValue;
+    if (tb_root_move(position, result.bestMove, tbValue)) {
+        result.score = tb_score(tbValue, 0);
+        result.tbHits = 1;
+        CHESS_COUNT(COUNTER_TB_HITS, 1);
+        result.seconds = elapsed();
+        return result;
+    }
+
+    // Budget de temps : la limite dure arrête la recherche en cours, la limite
+    // souple empêche de commencer une itération qui n'aurait pas le temps de finir
+    double softLimit = 0, hardLimit = 0;
+    Player us = position.sideToMove;
+    if (limits.movetime > 0) {
+        hardLimit = limits.movetime / 1000.0;
+        softLimit = hardLimit / 2;
+    } else if (limits.time[us] > 0) {
+        double remaining = limits.time[us] / 1000.0;
+        softLimit = remaining / 30 + limits.increment[us] / 1000.0 * 3 / 4;
+        hardLimit = std::min(remaining / 4, softLimit * 4);
+        softLimit = std::min(softLimit, hardLimit) / 2;
+    }
+
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> sharedNodes(0);
+    TT.new_search();
+
+    int threadCount = std::max(1, limits.threads);
+    std::vector<std::unique_ptr<Searcher>> searchers;
+    for (int i = 0; i < threadCount; i++) {
+        searchers.emplace_back(new Searcher());
+        Searcher& s = *searchers.back();
+        s.pos = position;
+        s.history = history;
+        s.nodeLimit = limits.nodes;
+        s.stopFlag = &stop;
+        s.sharedNodes = &sharedNodes;
+        s.useNnue = limits.nnue && nnue_enabled();
+        if (s.useNnue) {
+            s.nnue.reset(position);
+        }
+    }
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; i++) {
+        helpers.emplace_back(helper_thread, searchers[i].get(), i);
+    }
+
+    // Thread principal : c'est lui qui décide de la profondeur atteinte et du coup joué
+    Searcher& mainSearcher = *searchers[0];
+    mainSearcher.externalStop = limits.stop;
+    if (hardLimit > 0) {
+        mainSearcher.checkTime = true;
+        mainSearcher.deadline = start + std::chrono::microseconds(static_cast<int64_t>(hardLimit * 1e6));
+    }
+    MoveList rootMoves;
+    generate_moves(mainSearcher.pos, rootMoves);
+    int maxDepth = std::max(1, std::min(limits.depth, MAX_PLY - 1));
+    uint64_t previousNodes = 0;
+    for (int depth = 1; depth <= maxDepth && rootMoves.size > 0; depth++) {
+        int score;
+        if (!mainSearcher.search_root(rootMoves, depth, score)) {
+            break;
+        }
+        result.bestMove = rootMoves.moves[0];
+        result.score = score;
+        result.depth = depth;
+
+        uint64_t total = sharedNodes.load(std::memory_order_relaxed);
+        for (const auto& s : searchers) {
+            total += s->nodes % NODE_BATCH; // Noeuds pas encore publiés
+        }
+        result.iterations.push_back({depth, total, elapsed()});
+        result.branching = previousNodes > 0 ? static_cast<double>(total) / previousNodes : 0;
+        previousNodes = total;
+
+        if (softLimit > 0 && elapsed() >= softLimit) {
+            break;
+        }
+        if (std::abs(score) >= SCORE_WIN - depth) {
+            break; // Gain ou perte forcés trouvés : chercher plus loin ne changera rien
+        }
+    }
+    stop.store(true);
+    for (std::thread& t : helpers) {
+        t.join();
+    }
+
+    if (result.bestMove == MOVE_NONE && rootMoves.size > 0) {
+        result.bestMove = rootMoves.moves[0]; // Budget épuisé avant la fin de la première itération
+    }
+    result.seconds = elapsed();
+    for (const auto& s : searchers) {
+        result.nodes += s->nodes;
+        result.tbHits += s->tbHits;
+        result.qnodes += s->qnodes;
+        result.ttProbes += s->ttProbes;
+        result.ttHits += s->ttHits;
+        result.cutoffs += s->cutoffs;
+        result.firstMoveCutoffs += s->firstMoveCutoffs;
+        result.threadNps.push_back(result.seconds > 0 ? s->nodes / result.seconds : 0);
+    }
+    result.nps = result.seconds > 0 ? result.nodes / result.seconds : 0;
+    CHESS_COUNT(COUNTER_NODES, result.nodes);
+    CHESS_COUNT(COUNTER_QNODES, result.qnodes);
+    CHESS_COUNT(COUNTER_TT_PROBES, result.ttProbes);
+    CHESS_COUNT(COUNTER_TT_HITS, result.ttHits);
+    CHESS_COUNT(COUNTER_CUTOFFS, result.cutoffs);
+    CHESS_COUNT(COUNTER_FIRST_MOVE_CUTOFFS, result.firstMoveCutoffs);
+    CHESS_COUNT(COUNTER_TB_HITS, result.tbHits);
+    return result;
+}
+
+size_t search_thread_memory() {
+    return sizeof(Searcher);
+}
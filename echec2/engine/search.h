@@ -0,0 +1,68 @@
+#ifndef CHESS_SEARCH_H
+#define CHESS_SEARCH_H
+
+#include <atomic>
+#include <vector>
+#include "position.h"
+#include "eval.h"
+
+class MctsArena;
+
+// Moteur utilisé par search() : alpha-bêta, ou Monte-Carlo (mcts.h)
+enum SearchEngine { ENGINE_ALPHA_BETA, ENGINE_MCTS };
+
+// Limites d'une recherche ; 0 signifie « pas de limite » pour les noeuds et les temps.
+// Les temps sont en millisecondes : soit un temps fixe par coup, soit la pendule
+// du joueur au trait et son incrément.
+struct SearchLimits {
+    int depth = 5;
+    uint64_t nodes = 0;
+    int threads = 1;        // Le thread principal plus threads - 1 assistants (Lazy SMP)
+    int movetime = 0;
+    int time[2] = {0, 0};
+    int increment[2] = {0, 0};
+    const std::atomic<bool>* stop = nullptr; // Arrêt demandé par un autre thread (réflexion abandonnée)
+    SearchEngine engine = ENGINE_ALPHA_BETA; // Avec ENGINE_MCTS, nodes compte les simulations
+    bool nnue = true;                        // Évaluation neuronale si un réseau est chargé (nnue.h)
+    bool book = true;                        // Coup du livre d'ouverture s'il est chargé (book.h)
+    MctsArena* arena = nullptr;              // Réserve Monte-Carlo gardée par l'appelant (mcts.h), sinon une par recherche
+};
+
+// Fin d'une itération de l'approfondissement du thread principal
+struct DepthReport {
+    int depth;
+    uint64_t nodes;  // Noeuds cumulés de tous les threads à la fin de l'itération
+    double seconds;  // Temps écoulé depuis le début de la recherche
+};
+
+// Résultat d'une recherche et ses mesures de performance
+struct SearchResult {
+    Move bestMove = MOVE_NONE;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;       // Noeuds visités par tous les threads, quiescence comprise
+    double seconds = 0;
+    double nps = 0;           // Noeuds par seconde
+    double branching = 0;     // Facteur de branchement effectif des deux dernières itérations
+    uint64_t tbHits = 0;      // Positions lues dans les tables de finales (1 si la racine y est)
+    bool bookMove = false;    // Coup lu dans le livre d'ouverture, sans recherche
+    uint64_t qnodes = 0;      // Le reste n'est compté qu'avec CHESS_INSTRUMENT : noeuds de quiescence,
+    uint64_t ttProbes = 0;    // consultations et succès de la table de transposition,
+    uint64_t ttHits = 0;
+    uint64_t cutoffs = 0;     // coupures bêta et celles obtenues dès le premier coup
+    uint64_t firstMoveCutoffs = 0;
+    uint64_t playouts = 0;    // Parties simulées (Monte-Carlo seulement)
+    std::vector<DepthReport> iterations; // Courbe temps/profondeur
+    std::vector<double> threadNps;       // Noeuds par seconde de chaque thread
+};
+
+// Chercher le meilleur coup pour le joueur au trait (approfondissement itératif,
+// avec threads assistants Lazy SMP si limits.threads > 1, ou Monte-Carlo si
+// limits.engine le demande) ; le livre d'ouverture répond d'abord s'il connaît la position
+SearchResult search(const Position& position, const SearchLimits& limits, const std::vector<uint64_t>* history = nullptr);
+
+// Octets de l'état d'un thread de recherche alpha-bêta (position, pile de coups, coups
+// tueurs, historique, accumulateurs), alloué par search() le temps d'une recherche
+size_t search_thread_memory();
+
+#endif
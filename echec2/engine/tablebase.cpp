@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>     // Pour open
+#include <sys/mman.h>  // Pour mmap
+#include <sys/stat.h>
+#include <unistd.h>
+#include "tablebase.h"
+#include "movegen.h"
+
+// Une table chargée : les entrées pointent dans la projection du fichier
+struct TableFile {
+    const int8_t* entries = nullptr;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+// Indexées par (masque du trait, masque adverse) ; une case vide si la table manque
+static TableFile tables[16][16];
+static int maxLoadedPieces = 0;
+
+static const char TB_MAGIC[8] = {'Q', 'N', 'R', 'B', 'T', 'B', '1', '\0'};
+
+static uint32_t read_u32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint64_t read_u64(const uint8_t* p) {
+    return read_u32(p) | (static_cast<uint64_t>(read_u32(p + 4)) << 32);
+}
+
+int tb_material_mask(const Position& pos, Player player) {
+    int mask = 0;
+    for (int type = QUEEN; type <= BISHOP; type++) {
+        if (pos.counts[player][type] > 1) {
+            return -1; // Deux pièces du même type : hors des tables
+        }
+        if (pos.counts[player][type] == 1) {
+            mask |= 1 << (type - 1);
+        }
+    }
+    return mask;
+}
+
+std::string tb_table_name(int stmMask, int otherMask) {
+    const char letters[] = "QNRB";
+    std::string name;
+    for (int side = 0; side < 2; side++) {
+        int mask = side == 0 ? stmMask : otherMask;
+        for (int bit = 0; bit < 4; bit++) {
+            if (mask & (1 << bit)) {
+                name += letters[bit];
+            }
+        }
+        name += side == 0 ? "v" : ".qtb";
+    }
+    return name;
+}
+
+// Case de la première pièce : l'une des dix du triangle a1-d1-d4
+static const int TriangleSquares[10] = {
+    square_of(0, 0), square_of(1, 0), square_of(2, 0), square_of(3, 0), square_of(1, 1),
+    square_of(2, 1), square_of(3, 1), square_of(2, 2), square_of(3, 2), square_of(3, 3),
+};
+static const int8_t TriangleIndex[SQUARE_COUNT] = {
+     0,  1,  2,  3, -1, -1, -1, -1,
+    -1,  4,  5,  6, -1, -1, -1, -1,
+    -1, -1,  7,  8, -1, -1, -1, -1,
+    -1, -1, -1,  9, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+// Symétrie du plateau qui amène square dans le triangle : bit 0 miroir gauche-droite,
+// bit 1 miroir haut-bas, bit 2 échange des colonnes et des rangées (appliqué en dernier)
+static int triangle_symmetry(int square) {
+    int x = square_x(square), y = square_y(square), symmetry = 0;
+    if (x > 3) {
+        x = 7 - x;
+        symmetry |= 1;
+    }
+    if (y > 3) {
+        y = 7 - y;
+        symmetry |= 2;
+    }
+    return y > x ? symmetry | 4 : symmetry;
+}
+
+static int transform(int square, int symmetry) {
+    int x = square_x(square), y = square_y(square);
+    if (symmetry & 1) {
+        x = 7 - x;
+    }
+    if (symmetry & 2) {
+        y = 7 - y;
+    }
+    return (symmetry & 4) ? square_of(y, x) : square_of(x, y);
+}
+
+uint64_t tb_table_size(int pieces) {
+    uint64_t size = 10;
+    for (int k = 1; k < pieces; k++) {
+        size *= SQUARE_COUNT - k;
+    }
+    return size;
+}
+
+// Indice des cases après la symétrie : case du triangle de la première pièce, puis
+// rang de chaque pièce suivante parmi les cases que les précédentes laissent libres
+static uint64_t placement_index(const int* squares, int count, int symmetry) {
+    int placed[TB_MAX_PIECES];
+    placed[0] = transform(squares[0], symmetry);
+    uint64_t index = TriangleIndex[placed[0]];
+    for (int k = 1; k < count; k++) {
+        placed[k] = transform(squares[k], symmetry);
+        int rank = placed[k];
+        for (int j = 0; j < k; j++) {
+            rank -= placed[j] < placed[k];
+        }
+        index = index * (SQUARE_COUNT - k) + rank;
+    }
+    return index;
+}
+
+uint64_t tb_index(const Position& pos, int stmMask, int otherMask) {
+    Player us = pos.sideToMove;
+    Player them = (us == PLAYER1) ? PLAYER2 : PLAYER1;
+    int squares[TB_MAX_PIECES];
+    int count = 0;
+    for (int side = 0; side < 2; side++) {
+        Player player = side == 0 ? us : them;
+        int mask = side == 0 ? stmMask : otherMask;
+        for (int type = QUEEN; type <= BISHOP; type++) {
+            if (mask & (1 << (type - 1))) {
+                squares[count++] = lsb(pos.pieces[player][type]);
+            }
+        }
+    }
+    // Les coups des quatre types sont symétriques : la position est ramenée à celle
+    // dont la première pièce est dans le triangle. Sur la diagonale a1-d4, deux
+    // orientations y mènent (l'une image de l'autre par la diagonale) : la plus petite
+    // des deux est gardée, pour que toutes les images d'une position aient le même indice.
+    int symmetry = triangle_symmetry(squares[0]);
+    uint64_t index = placement_index(squares, count, symmetry);
+    if (square_x(transform(squares[0], symmetry)) == square_y(transform(squares[0], symmetry))) {
+        index = std::min(index, placement_index(squares, count, symmetry ^ 4));
+    }
+    return index;
+}
+
+bool tb_position(Position* pos, uint64_t index, int stmMask, int otherMask) {
+    int count = popcount(stmMask) + popcount(otherMask);
+    if (index >= tb_table_size(count)) {
+        return false;
+    }
+    int ranks[TB_MAX_PIECES];
+    for (int k = count - 1; k > 0; k--) {
+        ranks[k] = static_cast<int>(index % (SQUARE_COUNT - k));
+        index /= SQUARE_COUNT - k;
+    }
+    Bitboard used = square_bb(TriangleSquares[index]);
+    int squares[TB_MAX_PIECES] = {TriangleSquares[index]};
+    for (int k = 1; k < count; k++) {
+        // ranks[k]-ième case libre
+        int square = 0;
+        for (int free = -1;; square++) {
+            free += (used & square_bb(square)) == 0;
+            if (free == ranks[k]) {
+                break;
+            }
+        }
+        squares[k] = square;
+        used |= square_bb(square);
+    }
+
+    clear_position(pos);
+    int k = 0;
+    for (int side = 0; side < 2; side++) {
+        Player player = side == 0 ? PLAYER1 : PLAYER2;
+        int mask = side == 0 ? stmMask : otherMask;
+        for (int type = QUEEN; type <= BISHOP; type++) {
+            if (mask & (1 << (type - 1))) {
+                put_piece(pos, squares[k++], static_cast<PieceType>(type), player);
+            }
+        }
+    }
+    return true;
+}
+
+// En-tête d'une table du format courant pour ce matériel, dans un fichier de size octets
+static bool header_valid(const uint8_t* header, size_t size, int stmMask, int otherMask) {
+    int pieces = popcount(stmMask) + popcount(otherMask);
+    uint64_t expected = tb_table_size(pieces);
+    return memcmp(header, TB_MAGIC, sizeof(TB_MAGIC)) == 0 && read_u32(header + 8) == TB_VERSION
+        && header[12] == stmMask && header[13] == otherMask && header[14] == pieces
+        && read_u64(header + 16) == expected && size == TB_HEADER_SIZE + expected;
+}
+
+bool tb_table_valid(const std::string& path, int stmMask, int otherMask) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t header[TB_HEADER_SIZE];
+    bool ok = fread(header, sizeof(header), 1, file) == 1 && fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? ftell(file) : -1;
+    fclose(file);
+    return size >= 0 && header_valid(header, static_cast<size_t>(size), stmMask, otherMask);
+}
+
+// Projeter un fichier et vérifier son en-tête ; false si absent ou invalide
+static bool map_table(const std::string& path, int stmMask, int otherMask, TableFile& table) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < TB_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const uint8_t* header = static_cast<const uint8_t*>(mapping);
+    if (!header_valid(header, size, stmMask, otherMask)) {
+        munmap(mapping, size);
+        return false;
+    }
+    table.entries = reinterpret_cast<const int8_t*>(header + TB_HEADER_SIZE);
+    table.mapping = mapping;
+    table.mappingSize = size;
+    return true;
+}
+
+int tb_init(const std::string& directory) {
+    tb_free();
+    int loaded = 0;
+    for (int stmMask = 1; stmMask < 16; stmMask++) {
+        for (int otherMask = 1; otherMask < 16; otherMask++) {
+            int pieces = popcount(stmMask) + popcount(otherMask);
+            if (pieces > TB_MAX_PIECES) {
+                continue;
+            }
+            std::string path = directory + "/" + tb_table_name(stmMask, otherMask);
+            if (map_table(path, stmMask, otherMask, tables[stmMask][otherMask])) {
+                loaded++;
+                maxLoadedPieces = std::max(maxLoadedPieces, pieces);
+            }
+        }
+    }
+    return loaded;
+}
+
+void tb_free() {
+    for (auto& row : tables) {
+        for (TableFile& table : row) {
+            if (table.mapping != nullptr) {
+                munmap(table.mapping, table.mappingSize);
+            }
+            table = TableFile();
+        }
+    }
+    maxLoadedPieces = 0;
+}
+
+int tb_max_pieces() {
+    return maxLoadedPieces;
+}
+
+bool tb_probe(const Position& pos, int& value) {
+    if (pos.counts[PLAYER1][EMPTY] + pos.counts[PLAYER2][EMPTY] > maxLoadedPieces) {
+        return false;
+    }
+    Player us = pos.sideToMove;
+    Player them = (us == PLAYER1) ? PLAYER2 : PLAYER1;
+    int stmMask = tb_material_mask(pos, us);
+    int otherMask = tb_material_mask(pos, them);
+    if (stmMask <= 0 || otherMask <= 0) {
+        return false;
+    }
+    const TableFile& table = tables[stmMask][otherMask];
+    if (table.entries == nullptr) {
+        return false;
+    }
+    value = table.entries[tb_index(pos, stmMask, otherMask)];
+    return true;
+}
+
+bool tb_root_move(const Position& pos, Move& best, int& value) {
+    if (pos.counts[PLAYER1][EMPTY] + pos.counts[PLAYER2][EMPTY] > maxLoadedPieces) {
+        return false;
+    }
+    MoveList moves;
+    generate_moves(pos, moves);
+    if (moves.size == 0) {
+        return false;
+    }
+    Player them = (pos.sideToMove == PLAYER1) ? PLAYER2 : PLAYER1;
+    // Rang d'une valeur : gain court > gain long > nulle > perte longue > perte courte
+    auto rank = [](int v) { return v > 0 ? 1000 - v : v < 0 ? -1000 - v : 0; };
+    best = MOVE_NONE;
+    for (Move m : moves) {
+        int v;
+        if (move_captured(m) != EMPTY && pos.counts[them][EMPTY] == 1) {
+            v = 1; // Dernière pièce adverse prise
+        } else {
+            Position child = pos;
+            apply_move(child, m);
+            int childValue;
+            if (!tb_probe(child, childValue)) {
+                return false;
+            }
+            v = childValue < 0 ? 1 - childValue : childValue > 0 ? -1 - childValue : 0;
+        }
+        if (best == MOVE_NONE || rank(v) > rank(value)) {
+            best = m;
+            value = v;
+        }
+    }
+    return true;
+}
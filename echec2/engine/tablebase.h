@@ -0,0 +1,79 @@
+#ifndef CHESS_TABLEBASE_H
+#define CHESS_TABLEBASE_H
+
+#include <string>
+#include "position.h"
+
+// Tables de finales exactes pour cette variante (QUEEN, KNIGHT, ROOK, BISHOP, au
+// plus une pièce de chaque type par joueur). Une table couvre un matériel : les types
+// du joueur au trait et ceux de l'adversaire, chacun sous forme de masque de 4 bits.
+//
+// Chaque entrée tient sur un octet signé : 0 pour une nulle, n > 0 si le joueur au
+// trait gagne en n demi-coups, -n s'il perd en n demi-coups.
+//
+// Indice : les pièces sont prises dans l'ordre (joueur au trait d'abord, chaque camp
+// dans l'ordre des types). Les coups des quatre types étant symétriques, la position
+// est d'abord tournée ou retournée pour que la première pièce soit dans le triangle
+// a1-d1-d4 (10 cases) ; chaque pièce suivante est numérotée parmi les cases laissées
+// libres par les précédentes (63, puis 62...). Il n'y a donc aucune entrée pour deux
+// pièces sur une même case. Si la première pièce est sur la diagonale a1-d4, la
+// position et son image par cette diagonale ont deux places : tb_index rend la plus
+// petite, l'autre reçoit la même valeur. Les pièces d'un camp étant toutes de types
+// différents, aucune permutation n'est à retirer.
+// Taille d'une table : 10 * 63 * 62 * ... octets, soit 630 (2 pièces), 39 060 (3),
+// 2 382 660 (4) et 142 959 600 (5, environ 136 Mio) ; toutes les tables jusqu'à 4
+// pièces tiennent en 170 Mo, les 56 tables de 5 pièces en 8 Go. chess_tbgen garde
+// 3 octets par entrée pour les deux tables d'une paire, soit environ 860 Mo de
+// mémoire pour une paire de 5 pièces.
+//
+// Fichier « <trait>v<adversaire>.qtb » (par exemple QRvB.qtb) : en-tête de 32 octets
+// en petit-boutiste, puis une entrée par indice.
+//   0  magic "QNRBTB1\0"      8  version (u32)        12 masque du trait (u8)
+//   13 masque adverse (u8)    14 nombre de pièces (u8) 15 distance maximale (u8)
+//   16 nombre d'entrées (u64) 24 réservé
+
+#define TB_VERSION 2
+#define TB_HEADER_SIZE 32
+#define TB_MAX_PIECES 5
+
+// Masque des types présents pour un joueur (bit t - 1 pour le type t), ou -1 si
+// un type apparaît plus d'une fois
+int tb_material_mask(const Position& pos, Player player);
+
+// Nom de fichier d'une table, par exemple "QRvB.qtb"
+std::string tb_table_name(int stmMask, int otherMask);
+
+// Nombre d'entrées d'une table de pieces pièces
+uint64_t tb_table_size(int pieces);
+
+// Indice d'une position dans la table de son matériel, le même pour toutes ses
+// images par les symétries du plateau
+uint64_t tb_index(const Position& pos, int stmMask, int otherMask);
+
+// Reconstruire la position d'un indice, joueur 1 au trait ; false si l'indice dépasse
+// la table. La position peut être l'image par la diagonale de celle que tb_index range
+// à cet indice (voir plus haut).
+bool tb_position(Position* pos, uint64_t index, int stmMask, int otherMask);
+
+// Le fichier est-il une table complète de ce matériel, au format et à la version courants ?
+bool tb_table_valid(const std::string& path, int stmMask, int otherMask);
+
+// Charger par mmap toutes les tables d'un dossier ; retourne le nombre de tables
+int tb_init(const std::string& directory);
+void tb_free();
+
+// Plus grand nombre de pièces couvert par les tables chargées (0 si aucune)
+int tb_max_pieces();
+
+// Valeur exacte de la position, sans allocation ; false si aucune table ne la couvre
+bool tb_probe(const Position& pos, int& value);
+
+// Score de recherche d'une valeur de table, pour un noeud situé à ply de la racine
+inline int tb_score(int value, int ply) {
+    return value > 0 ? SCORE_WIN - ply - value : value < 0 ? -SCORE_WIN + ply - value : 0;
+}
+
+// Meilleur coup selon les tables : le gain le plus court, ou la perte la plus longue
+bool tb_root_move(const Position& pos, Move& best, int& value);
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef CHESS_TT_H
+#define CHESS_TT_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <algorithm>
+#include "types.h"
+
+// Type de borne d'un score stocké dans la table de transposition
+enum Bound { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+// Contenu décodé d'une entrée de la table de transposition
+struct TTData {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Entrée de 16 octets. La clé est stockée XOR les données : si deux threads
+// écrivent en même temps, la vérification échoue au lieu de renvoyer un mélange.
+struct TTEntry {
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+};
+
+// Quatre entrées par ligne de cache de 64 octets
+#define TT_BUCKET_SIZE 4
+struct alignas(64) TTBucket {
+    TTEntry entries[TT_BUCKET_SIZE];
+};
+
+// Table de transposition de taille fixe, partagée sans verrou entre les threads de recherche
+class TranspositionTable {
+public:
+    // Allouer la table (taille en Mo, arrondie à une puissance de deux de lignes)
+    void resize(size_t megabytes);
+    void clear();
+
+    // Nouvelle recherche : les anciennes entrées deviennent remplaçables en priorité.
+    // Plusieurs recherches indépendantes peuvent partager la table (parties en parallèle).
+    void new_search() { generation.store((generation.load(std::memory_order_relaxed) + 1) & 63, std::memory_order_relaxed); }
+
+    bool probe(uint64_t key, TTData& out) const {
+        const TTBucket& bucket = buckets[key & mask];
+        for (const TTEntry& e : bucket.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            if ((e.keyXorData.load(std::memory_order_relaxed) ^ data) == key && data != 0) {
+                out.move = static_cast<Move>(data & 0xFFFF);
+                out.score = static_cast<int16_t>((data >> 16) & 0xFFFF);
+                out.depth = static_cast<int>((data >> 32) & 0xFF);
+                out.bound = static_cast<Bound>((data >> 40) & 3);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, int depth, Bound bound, int score, Move move) {
+        TTBucket& bucket = buckets[key & mask];
+        TTEntry* replace = &bucket.entries[0];
+        int currentGeneration = generation.load(std::memory_order_relaxed);
+        int worst = SCORE_INFINITE;
+        for (TTEntry& e : bucket.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            if (data == 0 || (e.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+                if (move == MOVE_NONE && data != 0) {
+                    move = static_cast<Move>(data & 0xFFFF); // Garder le meilleur coup déjà connu
+                }
+                replace = &e;
+                break;
+            }
+            // Remplacer l'entrée la moins profonde, en pénalisant les entrées anciennes
+            int age = (currentGeneration - static_cast<int>((data >> 42) & 63)) & 63;
+            int value = static_cast<int>((data >> 32) & 0xFF) - 8 * age;
+            if (value < worst) {
+                worst = value;
+                replace = &e;
+            }
+        }
+        uint64_t data = static_cast<uint64_t>(move)
+                      | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16)
+                      | (static_cast<uint64_t>(std::max(depth, 0) & 0xFF) << 32)
+                      | (static_cast<uint64_t>(bound) << 40)
+                      | (static_cast<uint64_t>(currentGeneration) << 42);
+        replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+        replace->data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    std::unique_ptr<TTBucket[]> buckets;
+    size_t mask = 0;
+    std::atomic<int> generation{0};
+};
+
+extern TranspositionTable TT;
+
+// Les scores de victoire sont relatifs à la racine ; dans la table ils sont relatifs au noeud
+inline int score_to_tt(int score, int ply) {
+    return score >= SCORE_WIN_MIN ? score + ply : score <= -SCORE_WIN_MIN ? score - ply : score;
+}
+inline int score_from_tt(int score, int ply) {
+    return score >= SCORE_WIN_MIN ? score - ply : score <= -SCORE_WIN_MIN ? score + ply : score;
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef CHESS_TYPES_H
+#define CHESS_TYPES_H
+
+#include <cstdint>
+#include <type_traits>
+
+#define BOARD_SIZE 8 // Le plateau du jeu ; position.h et movegen.h acceptent aussi 10 et 12
+#define SQUARE_COUNT (BOARD_SIZE * BOARD_SIZE)
+
+// Enumération pour les types de pièces
+typedef enum { EMPTY, QUEEN, KNIGHT, ROOK, BISHOP } PieceType;
+#define PIECE_TYPE_COUNT 5
+
+// Enumération pour les joueurs
+typedef enum { PLAYER1, PLAYER2 } Player;
+
+// Un bitboard : un bit par case, case = y * BOARD_SIZE + x
+typedef uint64_t Bitboard;
+
+// Contenu d'une case de la mailbox : 0 pour une case vide, sinon type | (joueur << 3)
+inline uint8_t piece_code(PieceType type, Player player) { return static_cast<uint8_t>(type | (player << 3)); }
+inline PieceType code_type(uint8_t code) { return static_cast<PieceType>(code & 7); }
+inline Player code_player(uint8_t code) { return static_cast<Player>(code >> 3); }
+
+constexpr int square_of(int x, int y) { return y * BOARD_SIZE + x; }
+constexpr bool on_board(int x, int y) { return x >= 0 && x < BOARD_SIZE && y >= 0 && y < BOARD_SIZE; }
+constexpr int square_x(int square) { return square % BOARD_SIZE; }
+constexpr int square_y(int square) { return square / BOARD_SIZE; }
+constexpr Bitboard square_bb(int square) { return Bitboard(1) << square; }
+
+// Indice du bit le plus faible, puis retrait de ce bit
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int pop_lsb(Bitboard& b) { int square = lsb(b); b &= b - 1; return square; }
+inline int popcount(Bitboard b) { return __builtin_popcountll(b); }
+
+// Générateur xorshift64* à graine fixe : magiques et clés de Zobrist reproductibles
+struct Prng {
+    uint64_t state;
+    explicit Prng(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+    uint64_t sparse() { return next() & next() & next(); } // Peu de bits à 1 : bons candidats magiques
+};
+
+// Codage d'un coup sur un plateau N x N : case de départ, case d'arrivée, puis type
+// de la pièce capturée (EMPTY pour un coup tranquille). Jusqu'au 8x8 les cases
+// prennent 6 bits et le coup 16 ; au-delà, 8 bits par case et un coup de 32 bits.
+template <int N>
+struct MoveCoding {
+    typedef typename std::conditional<N * N <= 64, uint16_t, uint32_t>::type Type;
+    static constexpr int BITS = N * N <= 64 ? 6 : 8;
+    static constexpr int MASK = (1 << BITS) - 1;
+
+    static Type encode(int from, int to, PieceType captured) {
+        return static_cast<Type>(from | (to << BITS) | (captured << (2 * BITS)));
+    }
+    static int from(Type m) { return m & MASK; }
+    static int to(Type m) { return (m >> BITS) & MASK; }
+    static PieceType captured(Type m) { return static_cast<PieceType>((m >> (2 * BITS)) & 7); }
+};
+
+// Un coup du jeu tient sur 16 bits : case de départ (bits 0-5), case d'arrivée
+// (bits 6-11) et type de la pièce capturée (bits 12-14)
+typedef MoveCoding<BOARD_SIZE>::Type Move;
+const Move MOVE_NONE = 0; // Départ et arrivée sur la même case : jamais un vrai coup
+
+inline Move encode_move(int from, int to, PieceType captured) { return MoveCoding<BOARD_SIZE>::encode(from, to, captured); }
+inline int move_from(Move m) { return MoveCoding<BOARD_SIZE>::from(m); }
+inline int move_to(Move m) { return MoveCoding<BOARD_SIZE>::to(m); }
+inline PieceType move_captured(Move m) { return MoveCoding<BOARD_SIZE>::captured(m); }
+
+// Avec quatre pièces par joueur, une position compte au plus 62 coups ;
+// la marge couvre les positions chargées depuis un fichier
+#define MAX_MOVES 256
+
+// Profondeur maximale de la pile d'annulation (et donc d'une recherche)
+#define MAX_PLY 128
+
+// Bornes des scores : une victoire vaut SCORE_WIN moins la distance en demi-coups
+#define SCORE_INFINITE 32000
+#define SCORE_WIN 31000
+// Tout score au-delà est un gain forcé : distance dans l'arbre plus distance lue
+// dans les tables de finales (au plus 127 demi-coups)
+#define SCORE_WIN_MIN (SCORE_WIN - 2 * MAX_PLY)
+
+#endif
@@ -0,0 +1,117 @@
+#include "worker.h"
+#include "movegen.h"
+
+SearchWorker::SearchWorker() : thread(&SearchWorker::run, this) {}
+
+SearchWorker::~SearchWorker() {
+    Job quit;
+    quit.kind = JOB_QUIT;
+    post(quit);
+    thread.join();
+}
+
+// Déposer une demande : l'arrêt de la recherche en cours et la nouvelle demande sont
+// posés sous le même verrou, pour que le thread ne puisse pas prendre l'une sans l'autre
+void SearchWorker::post(Job& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(job);
+        stopFlag.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+void SearchWorker::go(const Position& pos, const std::vector<uint64_t>& history, const SearchLimits& limits) {
+    Job job;
+    job.kind = JOB_SEARCH;
+    job.pos = pos;
+    job.history = history;
+    job.limits = limits;
+    job.id = ++requested;
+    post(job);
+}
+
+void SearchWorker::ponder(const Position& pos, const std::vector<uint64_t>& history, Move predicted, const SearchLimits& limits) {
+    if (!is_pseudo_legal(pos, predicted)) {
+        return;
+    }
+    Job job;
+    job.kind = JOB_PONDER;
+    job.pos = pos;
+    job.history = history;
+    job.history.push_back(pos.state.key);
+    apply_move(job.pos, predicted);
+    job.limits = limits;
+    job.limits.depth = MAX_PLY - 1; // Jusqu'à ce que l'adversaire joue
+    job.limits.nodes = 0;
+    job.limits.movetime = 0;
+    job.limits.time[PLAYER1] = job.limits.time[PLAYER2] = 0;
+    post(job);
+}
+
+void SearchWorker::stop() {
+    stopFlag.store(true, std::memory_order_relaxed);
+}
+
+// Une réflexion ne remplace une recherche que si les deux ont la même configuration
+static bool same_configuration(const SearchLimits& a, const SearchLimits& b) {
+    return a.engine == b.engine && a.threads == b.threads && a.nnue == b.nnue && a.book == b.book;
+}
+
+bool SearchWorker::poll(SearchResult& result) {
+    if (consumed == requested || published.load(std::memory_order_acquire) != requested) {
+        return false;
+    }
+    result = mailbox;
+    consumed = requested;
+    return true;
+}
+
+void SearchWorker::run() {
+    // Dernière réflexion menée à son terme : position visée et résultat
+    uint64_t ponderKey = 0;
+    bool ponderComplete = false;
+    SearchLimits ponderLimits;
+    SearchResult ponderResult;
+
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return pending.kind != JOB_NONE; });
+            job = std::move(pending);
+            pending.kind = JOB_NONE;
+            stopFlag.store(false, std::memory_order_relaxed);
+        }
+        if (job.kind == JOB_QUIT) {
+            return;
+        }
+        job.limits.stop = &stopFlag;
+        if (job.limits.engine == ENGINE_MCTS && job.limits.arena == nullptr) {
+            if (!arena) {
+                arena.reset(new MctsArena());
+            }
+            job.limits.arena = arena.get();
+        }
+
+        if (job.kind == JOB_PONDER) {
+            ponderKey = job.pos.state.key;
+            ponderLimits = job.limits;
+            ponderResult = search(job.pos, job.limits, &job.history);
+            ponderComplete = !stopFlag.load(std::memory_order_relaxed) && ponderResult.bestMove != MOVE_NONE;
+            continue;
+        }
+
+        // Coup prévu joué et réflexion déjà terminée : la réponse est prête
+        SearchResult result;
+        if (ponderComplete && ponderKey == job.pos.state.key && same_configuration(ponderLimits, job.limits)) {
+            result = ponderResult;
+            ponderHits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            result = search(job.pos, job.limits, &job.history);
+        }
+        ponderComplete = false;
+        mailbox = result;
+        published.store(job.id, std::memory_order_release);
+    }
+}
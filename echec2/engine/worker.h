@@ -0,0 +1,72 @@
+#ifndef CHESS_WORKER_H
+#define CHESS_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "search.h"
+#include "mcts.h"
+
+// Recherche sur un thread dédié, pour qu'une interface ne soit jamais bloquée.
+// Le thread appelant dépose une demande et revient aussitôt ; le résultat est publié
+// dans une boîte aux lettres sans verrou (le résultat, puis le numéro de la demande)
+// que l'appelant consulte quand il veut.
+//
+// Pendant que l'adversaire réfléchit, le thread cherche la position après le coup
+// qu'il prévoit (réflexion sur le temps adverse). Si l'adversaire joue ce coup, la
+// table de transposition est déjà remplie et la réponse est presque immédiate, voire
+// immédiate si la réflexion a abouti d'elle-même.
+class SearchWorker {
+public:
+    SearchWorker();
+    ~SearchWorker();
+
+    // Chercher un coup ; remplace et interrompt le travail en cours
+    void go(const Position& pos, const std::vector<uint64_t>& history, const SearchLimits& limits);
+
+    // Réfléchir sur la position obtenue si l'adversaire joue predicted, avec la
+    // configuration (moteur, threads, évaluation, livre) de la prochaine demande go ;
+    // seuls la profondeur et les temps sont levés
+    void ponder(const Position& pos, const std::vector<uint64_t>& history, Move predicted, const SearchLimits& limits);
+
+    // Interrompre le travail en cours, sans attendre
+    void stop();
+
+    // Résultat de la dernière demande go, une seule fois, s'il est prêt ; ne bloque jamais
+    bool poll(SearchResult& result);
+
+    // Réponses servies directement par une réflexion terminée
+    uint64_t ponder_hits() const { return ponderHits.load(std::memory_order_relaxed); }
+
+private:
+    enum JobKind { JOB_NONE, JOB_SEARCH, JOB_PONDER, JOB_QUIT };
+    struct Job {
+        JobKind kind = JOB_NONE;
+        Position pos;
+        std::vector<uint64_t> history;
+        SearchLimits limits;
+        uint32_t id = 0;
+    };
+
+    void post(Job& job);
+    void run();
+
+    std::mutex mutex;               // Ne protège que le dépôt d'une demande, jamais une recherche
+    std::condition_variable wake;
+    Job pending;
+    std::atomic<bool> stopFlag{false};
+
+    SearchResult mailbox;           // Écrit par le thread de recherche avant publication
+    std::atomic<uint32_t> published{0};
+    uint32_t requested = 0;         // Côté appelant : dernière demande go et dernière lue
+    uint32_t consumed = 0;
+    std::atomic<uint64_t> ponderHits{0};
+    std::unique_ptr<MctsArena> arena; // Arbre Monte-Carlo du thread, créé à la première recherche qui en a besoin
+
+    std::thread thread;             // Déclaré en dernier : démarre une fois le reste construit
+};
+
+#endif
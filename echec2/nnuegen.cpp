@@ -0,0 +1,73 @@
+#include <iostream>
+#include <memory>
+#include <cstdlib>
+#include "engine/nnue.h"
+
+// Générateur d'un réseau pour nnue.h, sans entraînement.
+// Usage : chess_nnuegen [fichier] [graine]
+//
+// Les huit premiers neurones de la couche de caractéristiques comptent les pièces de
+// chaque (camp, type), avec une petite prime de centralisation tirée de PieceSquare ;
+// la couche dense les recopie et la sortie les pèse de PieceValue. Le réseau retrouve
+// donc à peu près l'évaluation matérielle d'eval.h. Les autres neurones reçoivent des
+// poids aléatoires de faible influence : ils occupent toute la largeur des noyaux,
+// ce qui sert à vérifier que les chemins SIMD et scalaire donnent le même score.
+
+#define NNUE_DEFAULT_FILE "chess_nnue.bin"
+#define PIECE_UNIT 32 // Valeur d'une pièce seule dans son neurone de comptage
+
+int main(int argc, char* argv[]) {
+    const char* filename = argc > 1 ? argv[1] : NNUE_DEFAULT_FILE;
+    Prng rng(argc > 2 ? strtoull(argv[2], nullptr, 10) : 2024);
+    auto random = [&rng](int low, int high) { return low + static_cast<int>(rng.next() % (high - low + 1)); };
+
+    std::unique_ptr<NnueWeights> w(new NnueWeights());
+
+    // Couche de caractéristiques : rangée (camp relatif * 4 + type - 1) * 64 + case
+    for (int relative = 0; relative < 2; relative++) {
+        for (int type = QUEEN; type <= BISHOP; type++) {
+            int counter = relative * 4 + type - 1;
+            for (int square = 0; square < SQUARE_COUNT; square++) {
+                int16_t* row = w->featureWeights[counter * SQUARE_COUNT + square];
+                row[counter] = static_cast<int16_t>(PIECE_UNIT + PieceSquare.values[type][square] * PIECE_UNIT / PieceValue[type]);
+                for (int i = 8; i < NNUE_HIDDEN; i++) {
+                    row[i] = static_cast<int16_t>(random(-6, 6));
+                }
+            }
+        }
+    }
+    for (int i = 8; i < NNUE_HIDDEN; i++) {
+        w->featureBias[i] = static_cast<int16_t>(random(0, 40));
+    }
+
+    // Couche dense : les huit compteurs du joueur au trait recopiés (poids 2^shift),
+    // puis des combinaisons aléatoires des autres neurones
+    for (int j = 0; j < NNUE_HEAD; j++) {
+        if (j < 8) {
+            w->headWeights[j][j] = 1 << NNUE_HEAD_SHIFT;
+            continue;
+        }
+        for (int i = 0; i < 2 * NNUE_HIDDEN; i++) {
+            if (i % NNUE_HIDDEN >= 8) {
+                w->headWeights[j][i] = static_cast<int16_t>(random(-3, 3));
+            }
+        }
+        w->headBias[j] = random(0, 64 << NNUE_HEAD_SHIFT);
+    }
+
+    // Sortie : matériel du trait moins matériel adverse, plus un peu de bruit
+    for (int type = QUEEN; type <= BISHOP; type++) {
+        w->outputWeights[type - 1] = static_cast<int16_t>(PieceValue[type]);
+        w->outputWeights[4 + type - 1] = static_cast<int16_t>(-PieceValue[type]);
+    }
+    for (int j = 8; j < NNUE_HEAD; j++) {
+        w->outputWeights[j] = static_cast<int16_t>(random(-1, 1));
+    }
+
+    if (!nnue_write(filename, *w)) {
+        std::cerr << "Impossible d'écrire " << filename << std::endl;
+        return 1;
+    }
+    std::cout << "Réseau écrit dans " << filename << " (" << NNUE_HEADER_SIZE + sizeof(NnueWeights) << " octets)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "assets.h"
+
+// Préparation de l'atlas de l'interface, lancée par la construction.
+// Usage : chess_pack_assets DOSSIER_IMAGES ATLAS
+//
+// Décode BB.png et les huit pièces, réduit chaque pièce à une case (proportions
+// gardées, centrée) et range le tout dans une seule image : le plateau à gauche, sans
+// son cadre pour que les cases tombent sur celles de la fenêtre, les pièces à droite,
+// une rangée par joueur, une colonne par type.
+
+#define BOARD_MARGIN 28 // Largeur du cadre de BB.png autour des 64 cases, en pixels
+
+// Réduire une image dans un rectangle de l'atlas : chaque pixel est la moyenne des
+// pixels source qu'il recouvre, pondérée par leur opacité pour ne pas assombrir les bords
+static void resample(const sf::Image& image, std::vector<uint8_t>& atlas, uint32_t atlasWidth, const AtlasRect& r) {
+    sf::Vector2u size = image.getSize();
+    const uint8_t* source = image.getPixelsPtr();
+    for (uint32_t ty = 0; ty < r.height; ty++) {
+        uint32_t y0 = ty * size.y / r.height, y1 = std::max(y0 + 1, (ty + 1) * size.y / r.height);
+        for (uint32_t tx = 0; tx < r.width; tx++) {
+            uint32_t x0 = tx * size.x / r.width, x1 = std::max(x0 + 1, (tx + 1) * size.x / r.width);
+            uint64_t color[3] = {0, 0, 0}, alpha = 0, count = 0;
+            for (uint32_t y = y0; y < y1; y++) {
+                for (uint32_t x = x0; x < x1; x++) {
+                    const uint8_t* p = source + 4 * (static_cast<size_t>(y) * size.x + x);
+                    for (int c = 0; c < 3; c++) {
+                        color[c] += p[c] * p[3];
+                    }
+                    alpha += p[3];
+                    count++;
+                }
+            }
+            uint8_t* out = atlas.data() + 4 * (static_cast<size_t>(r.y + ty) * atlasWidth + r.x + tx);
+            for (int c = 0; c < 3; c++) {
+                out[c] = alpha == 0 ? 0 : static_cast<uint8_t>(color[c] / alpha);
+            }
+            out[3] = static_cast<uint8_t>(alpha / count);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage : chess_pack_assets DOSSIER_IMAGES ATLAS" << std::endl;
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::string directory = std::string(argv[1]) + "/";
+
+    const char* names[ATLAS_SPRITES] = {
+        "BB.png",
+        "player1_queen.png", "player1_knight.png", "player1_rook.png", "player1_bishop.png",
+        "player2_queen.png", "player2_knight.png", "player2_rook.png", "player2_bishop.png",
+    };
+    sf::Image images[ATLAS_SPRITES];
+    for (int i = 0; i < ATLAS_SPRITES; i++) {
+        if (!images[i].loadFromFile(directory + names[i])) {
+            std::cerr << "Image illisible : " << directory + names[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // Emplacements : les cases du plateau à leur taille d'origine, chaque pièce ramenée à une case
+    sf::Vector2u frame = images[ATLAS_BOARD].getSize();
+    if (frame.x <= 2 * BOARD_MARGIN || frame.y <= 2 * BOARD_MARGIN) {
+        std::cerr << "Plateau trop petit : " << directory + names[ATLAS_BOARD] << std::endl;
+        return 1;
+    }
+    sf::Vector2u board(frame.x - 2 * BOARD_MARGIN, frame.y - 2 * BOARD_MARGIN);
+    AtlasRect sprites[ATLAS_SPRITES];
+    sprites[ATLAS_BOARD] = {0, 0, board.x, board.y};
+    for (int i = 1; i < ATLAS_SPRITES; i++) {
+        sf::Vector2u size = images[i].getSize();
+        uint32_t longest = std::max(size.x, size.y);
+        uint32_t width = std::max(1u, size.x * ATLAS_CELL_SIZE / longest);
+        uint32_t height = std::max(1u, size.y * ATLAS_CELL_SIZE / longest);
+        uint32_t column = (i - 1) % 4, row = (i - 1) / 4;
+        sprites[i] = {board.x + column * ATLAS_CELL_SIZE + (ATLAS_CELL_SIZE - width) / 2,
+                      row * ATLAS_CELL_SIZE + (ATLAS_CELL_SIZE - height) / 2, width, height};
+    }
+    uint32_t width = board.x + 4 * ATLAS_CELL_SIZE;
+    uint32_t height = std::max<uint32_t>(board.y, 2 * ATLAS_CELL_SIZE);
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4, 0);
+    for (uint32_t y = 0; y < board.y; y++) {
+        memcpy(pixels.data() + 4 * static_cast<size_t>(y) * width,
+               images[ATLAS_BOARD].getPixelsPtr() + 4 * (static_cast<size_t>(y + BOARD_MARGIN) * frame.x + BOARD_MARGIN),
+               4 * board.x);
+    }
+    for (int i = 1; i < ATLAS_SPRITES; i++) {
+        resample(images[i], pixels, width, sprites[i]);
+    }
+
+    if (!write_atlas(argv[2], width, height, sprites, pixels.data())) {
+        std::cerr << "Écriture impossible : " << argv[2] << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Atlas " << argv[2] << " : " << width << "x" << height << ", "
+              << ATLAS_HEADER_SIZE + pixels.size() << " octets, " << seconds * 1000 << " ms" << std::endl;
+    return 0;
+}
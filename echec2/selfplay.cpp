@@ -0,0 +1,380 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "engine/attacks.h"
+#include "engine/movegen.h"
+#include "engine/game.h"
+#include "engine/search.h"
+#include "engine/tt.h"
+#include "engine/tablebase.h"
+#include "engine/instrument.h"
+#include "engine/nnue.h"
+#include "engine/book.h"
+#include "engine/archive.h"
+
+// Parties du moteur contre lui-même, sans interface graphique.
+// Usage : chess_selfplay [--games N] [--concurrent N] [--threads N] [--depth N] [--nodes N]
+//                        [--a-depth N] [--a-nodes N] [--a-movetime MS]
+//                        [--b-depth N] [--b-nodes N] [--b-movetime MS]
+//                        [--a-engine ab|mcts] [--b-engine ab|mcts]
+//                        [--nnue RÉSEAU] [--a-eval nnue|material] [--b-eval nnue|material]
+//                        [--positions FICHIER] [--random-plies N] [--max-plies N]
+//                        [--hash MO] [--tables DOSSIER] [--stats FICHIER]
+//                        [--book LIVRE] [--archive ARCHIVE]
+//
+// Le moteur A affronte le moteur B. Les parties vont par paires : même ouverture,
+// couleurs inversées. Chaque ouverture part de la position de départ ou d'une ligne
+// du fichier de positions (notation de position_from_text), suivie de quelques coups
+// tirés au hasard pour que deux paires ne se ressemblent pas. Les résultats sont
+// donnés du point de vue de A. Avec --book, les deux moteurs jouent les coups du
+// livre tant qu'il connaît la position ; --archive ajoute chaque partie, depuis son
+// ouverture, à une archive (matière première de chess_book archive).
+//
+// --concurrent parties sont menées de front. Chacune ne garde que sa position, ses clés
+// de répétition et ses coups (pour l'archive) : les threads la reprennent tour à tour
+// dans une file, y jouent un coup, puis la remettent au bout. L'état de recherche (pile,
+// coups tueurs, historique, accumulateurs) appartient au thread et ne dure qu'un coup.
+
+#define DEFAULT_GAMES 100
+#define DEFAULT_CONCURRENT 1024 // Parties menées de front
+#define DEFAULT_RANDOM_PLIES 4
+#define DEFAULT_MAX_PLIES 200 // Partie déclarée nulle au-delà
+
+typedef std::chrono::steady_clock Clock;
+
+// Totaux partagés par les threads
+struct Tally {
+    std::atomic<uint64_t> wins{0}, draws{0}, losses{0};
+    std::atomic<uint64_t> plies{0}, nodes{0};
+    std::atomic<uint64_t> peakGameBytes{0}; // Plus grande mémoire occupée par une partie en cours
+    std::atomic<uint64_t> bookMoves{0};
+};
+
+// Archive des parties jouées, partagée par les threads
+struct GameArchive {
+    ArchiveWriter writer;
+    std::mutex lock;
+    bool open = false;
+};
+
+// Partie en cours, reprise à chaque coup par le thread qui la tire de la file
+struct LiveGame {
+    const Position* opening = nullptr; // Avant les coups au hasard, pour l'archive
+    Game game;
+    std::vector<Move> played;          // Gardés seulement avec --archive
+    Player playerA = PLAYER1;
+    int ply = 0;                       // Demi-coups joués par les moteurs
+};
+
+// Octets d'une partie en cours, réserves des listes comprises
+static uint64_t game_bytes(const LiveGame& live) {
+    return sizeof(LiveGame) + live.game.keys.capacity() * sizeof(uint64_t) + live.played.capacity() * sizeof(Move);
+}
+
+// Jouer un coup en ne gardant que les clés utiles aux répétitions : une prise rend
+// impossible le retour d'une position antérieure
+static void play_move(LiveGame& live, Move m, bool keepMoves) {
+    Game& game = live.game;
+    game.keys.push_back(game.pos.state.key);
+    apply_move(game.pos, m);
+    if (game.pos.state.pliesSinceCapture == 0) {
+        game.keys.clear();
+    }
+    if (keepMoves) {
+        live.played.push_back(m);
+    }
+}
+
+// Commencer la partie numéro g : ouverture de sa paire, couleur de A, coups au hasard.
+// Les listes sont réservées d'emblée pour la partie entière : agrandies au fil des
+// coups, elles se logeraient dans les trous laissés par l'état de chaque recherche et
+// morcelleraient le tas (plusieurs dizaines de Ko par partie avec 100 000 parties).
+static void start_game(LiveGame& live, int g, const std::vector<Position>& openings, int randomPlies, int maxPlies,
+                       bool keepMoves) {
+    int pair = g / 2;
+    live.playerA = (g % 2 == 0) ? PLAYER1 : PLAYER2;
+    live.opening = &openings[pair % openings.size()];
+    live.game.pos = *live.opening;
+    live.game.keys.clear();
+    live.played.clear();
+    live.ply = 0;
+    live.game.keys.reserve(randomPlies + maxPlies);
+    if (keepMoves) {
+        live.played.reserve(randomPlies + maxPlies);
+    }
+    Prng rng(0x9E3779B97F4A7C15ULL * (pair + 1));
+    for (int i = 0; i < randomPlies; i++) {
+        MoveList moves;
+        generate_moves(live.game.pos, moves);
+        if (moves.size == 0 || !hasRemainingPieces(&live.game.pos, live.game.pos.sideToMove)) {
+            break;
+        }
+        play_move(live, moves.moves[rng.next() % moves.size], keepMoves);
+    }
+}
+
+// Jouer le coup suivant d'une partie. Retourne true si elle est finie, result valant
+// alors 1 si A gagne, 0 pour une nulle, -1 si A perd.
+static bool advance_game(LiveGame& live, int maxPlies, const SearchLimits limits[2], Tally& tally, bool keepMoves,
+                         int& result) {
+    Game& game = live.game;
+    Player us = game.pos.sideToMove;
+    result = 0;
+    if (!hasRemainingPieces(&game.pos, us)) {
+        result = us == live.playerA ? -1 : 1; // Dernière pièce prise au demi-coup précédent
+        return true;
+    }
+    if (live.ply >= maxPlies || isThreefoldRepetition(&game)) {
+        return true;
+    }
+    SearchResult r = search(game.pos, limits[us == live.playerA ? 0 : 1], &game.keys);
+    tally.nodes += r.nodes;
+    if (r.bestMove == MOVE_NONE) {
+        return true; // Plus aucun coup : nulle
+    }
+    play_move(live, r.bestMove, keepMoves);
+    live.ply++;
+    tally.plies++;
+    tally.bookMoves += r.bookMove;
+    uint64_t bytes = game_bytes(live);
+    uint64_t peak = tally.peakGameBytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !tally.peakGameBytes.compare_exchange_weak(peak, bytes)) {
+    }
+    return false;
+}
+
+// Compter le résultat d'une partie finie et l'ajouter à l'archive
+static void finish_game(const LiveGame& live, int result, Tally& tally, GameArchive& archive) {
+    (result > 0 ? tally.wins : result < 0 ? tally.losses : tally.draws)++;
+    if (archive.open) {
+        Player winner = result > 0 ? live.playerA : (live.playerA == PLAYER1 ? PLAYER2 : PLAYER1);
+        ArchiveResult archived = result == 0 ? RESULT_DRAW : winner == PLAYER1 ? RESULT_PLAYER1_WINS : RESULT_PLAYER2_WINS;
+        std::lock_guard<std::mutex> guard(archive.lock);
+        archive.writer.write_game(live.opening, live.played.data(), static_cast<uint32_t>(live.played.size()), archived);
+    }
+}
+
+// Écart Elo correspondant à un score moyen entre 0 et 1
+static double elo_from_score(double score) {
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Lire les positions d'un fichier, une par ligne ; les lignes vides et '#' sont ignorées
+static bool load_positions(const char* filename, std::vector<Position>& positions) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Erreur d'ouverture du fichier de positions." << std::endl;
+        return false;
+    }
+    std::string line;
+    int number = 0;
+    while (std::getline(file, line)) {
+        number++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        Position pos;
+        if (!position_from_text(&pos, line.c_str())) {
+            std::cerr << "Position invalide ligne " << number << " : " << line << std::endl;
+            return false;
+        }
+        positions.push_back(pos);
+    }
+    return !positions.empty();
+}
+
+int main(int argc, char* argv[]) {
+    init_attacks();
+    init_zobrist();
+
+    int games = DEFAULT_GAMES;
+    int concurrent = DEFAULT_CONCURRENT;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    int randomPlies = DEFAULT_RANDOM_PLIES;
+    int maxPlies = DEFAULT_MAX_PLIES;
+    size_t hashMegabytes = 64;
+    const char* positionFile = nullptr;
+    const char* tableDirectory = "tables";
+    const char* statsFile = nullptr;
+    const char* networkFile = nullptr;
+    const char* bookFile = nullptr;
+    const char* archiveFile = nullptr;
+    SearchLimits limits[2]; // Moteurs A et B : profondeur fixe par défaut, reproductible
+    for (SearchLimits& l : limits) {
+        l.depth = 4;
+    }
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        const char* value = argv[i + 1];
+        if (option == "--games") {
+            games = atoi(value);
+        } else if (option == "--concurrent") {
+            concurrent = atoi(value);
+        } else if (option == "--threads") {
+            threads = atoi(value);
+        } else if (option == "--depth") {
+            limits[0].depth = limits[1].depth = atoi(value);
+        } else if (option == "--nodes") {
+            limits[0].nodes = limits[1].nodes = strtoull(value, nullptr, 10);
+        } else if (option == "--a-depth" || option == "--b-depth") {
+            limits[option[2] == 'a' ? 0 : 1].depth = atoi(value);
+        } else if (option == "--a-nodes" || option == "--b-nodes") {
+            limits[option[2] == 'a' ? 0 : 1].nodes = strtoull(value, nullptr, 10);
+        } else if (option == "--a-movetime" || option == "--b-movetime") {
+            limits[option[2] == 'a' ? 0 : 1].movetime = atoi(value);
+        } else if (option == "--a-engine" || option == "--b-engine") {
+            // Monte-Carlo : --X-nodes compte alors les simulations par coup
+            limits[option[2] == 'a' ? 0 : 1].engine = std::string(value) == "mcts" ? ENGINE_MCTS : ENGINE_ALPHA_BETA;
+        } else if (option == "--a-eval" || option == "--b-eval") {
+            // Avec --nnue, les deux moteurs prennent le réseau sauf si l'un demande le matériel
+            limits[option[2] == 'a' ? 0 : 1].nnue = std::string(value) != "material";
+        } else if (option == "--nnue") {
+            networkFile = value;
+        } else if (option == "--positions") {
+            positionFile = value;
+        } else if (option == "--random-plies") {
+            randomPlies = atoi(value);
+        } else if (option == "--max-plies") {
+            maxPlies = atoi(value);
+        } else if (option == "--hash") {
+            hashMegabytes = strtoull(value, nullptr, 10);
+        } else if (option == "--tables") {
+            tableDirectory = value;
+        } else if (option == "--stats") {
+            statsFile = value;
+        } else if (option == "--book") {
+            bookFile = value;
+        } else if (option == "--archive") {
+            archiveFile = value;
+        } else {
+            std::cerr << "Option inconnue : " << option << std::endl;
+            return 2;
+        }
+    }
+    if (games < 1) {
+        std::cerr << "Il faut au moins une partie (--games N)." << std::endl;
+        return 2;
+    }
+    threads = std::max(1, threads);
+    TT.resize(hashMegabytes); // Partagée par toutes les parties : la table est sans verrou
+    tb_init(tableDirectory);
+    if (networkFile != nullptr && !nnue_load(networkFile)) {
+        std::cerr << "Réseau introuvable ou invalide : " << networkFile << std::endl;
+        return 1;
+    }
+    if (bookFile != nullptr && !book_init(bookFile)) {
+        std::cerr << "Livre introuvable ou invalide : " << bookFile << std::endl;
+        return 1;
+    }
+    GameArchive archive;
+    if (archiveFile != nullptr) {
+        archive.open = archive.writer.open(archiveFile);
+        if (!archive.open) {
+            std::cerr << "Impossible d'ouvrir l'archive " << archiveFile << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Position> openings;
+    if (positionFile != nullptr) {
+        if (!load_positions(positionFile, openings)) {
+            return 1;
+        }
+    } else {
+        openings.emplace_back();
+        initialize_board(&openings.back());
+    }
+
+    // Parties menées de front, reprises un coup à la fois par la réserve de threads ;
+    // une partie finie laisse sa place à la suivante jusqu'à épuisement
+    Tally tally;
+    bool keepMoves = archive.open;
+    concurrent = std::max(1, std::min(concurrent, games));
+    threads = std::min(threads, concurrent);
+    std::vector<LiveGame> live(concurrent);
+    std::deque<LiveGame*> ready;
+    std::mutex readyLock;
+    std::atomic<int> nextGame(0);
+    auto start = Clock::now();
+    for (LiveGame& l : live) {
+        start_game(l, nextGame++, openings, randomPlies, maxPlies, keepMoves);
+        ready.push_back(&l);
+    }
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&]() {
+            for (;;) {
+                LiveGame* l;
+                {
+                    std::lock_guard<std::mutex> guard(readyLock);
+                    if (ready.empty()) {
+                        return; // Les parties restantes sont aux mains d'autres threads
+                    }
+                    l = ready.front();
+                    ready.pop_front();
+                }
+                int result;
+                if (advance_game(*l, maxPlies, limits, tally, keepMoves, result)) {
+                    finish_game(*l, result, tally, archive);
+                    int g = nextGame++;
+                    if (g >= games) {
+                        continue;
+                    }
+                    start_game(*l, g, openings, randomPlies, maxPlies, keepMoves);
+                }
+                std::lock_guard<std::mutex> guard(readyLock);
+                ready.push_back(l);
+            }
+        });
+    }
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Score moyen de A et intervalle de confiance à 95 % sur l'écart Elo
+    uint64_t w = tally.wins, d = tally.draws, l = tally.losses;
+    double n = static_cast<double>(w + d + l);
+    double score = (w + 0.5 * d) / n;
+    double variance = (w * std::pow(1 - score, 2) + d * std::pow(0.5 - score, 2) + l * std::pow(score, 2)) / n;
+    double margin = 1.96 * std::sqrt(variance / n);
+
+    std::cout << games << " parties en " << seconds << " s : " << (seconds > 0 ? games / seconds : 0)
+              << " parties/s, " << tally.plies / n << " demi-coups par partie, "
+              << static_cast<uint64_t>(seconds > 0 ? tally.nodes / seconds : 0) << " noeuds/s ("
+              << threads << " threads)" << std::endl;
+    if (tally.bookMoves > 0) {
+        std::cout << tally.bookMoves << " coups lus dans le livre d'ouverture" << std::endl;
+    }
+    std::cout << "A : +" << w << " =" << d << " -" << l << ", score " << score * 100 << " %" << std::endl;
+    if (score <= 0 || score >= 1) {
+        std::cout << "Elo : non borné (aucune partie gagnée par l'un des moteurs)" << std::endl;
+    } else {
+        double low = elo_from_score(std::max(score - margin, 1e-6));
+        double high = elo_from_score(std::min(score + margin, 1 - 1e-6));
+        std::cout << "Elo : " << elo_from_score(score) << " +/- " << (high - low) / 2 << " (95 %)" << std::endl;
+    }
+    std::cout << "Mémoire par partie : " << std::max<uint64_t>(tally.peakGameBytes, sizeof(LiveGame))
+              << " octets au plus (position, clés depuis la dernière prise" << (keepMoves ? ", coups pour l'archive" : "")
+              << "), " << concurrent << " parties menées de front" << std::endl;
+    int searchThreads = std::max(limits[0].threads, limits[1].threads);
+    std::cout << "Mémoire de recherche : " << search_thread_memory() * searchThreads
+              << " octets par thread le temps d'un coup (pile, coups tueurs, historique, accumulateurs)";
+    if (limits[0].engine == ENGINE_MCTS || limits[1].engine == ENGINE_MCTS) {
+        std::cout << ", plus la réserve de noeuds de chaque recherche Monte-Carlo";
+    }
+    std::cout << ", table de transposition partagée de " << hashMegabytes << " Mo" << std::endl;
+    if (statsFile != nullptr && !instrument_dump(statsFile)) {
+        std::cerr << "Impossible d'écrire " << statsFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
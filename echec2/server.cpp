@@ -0,0 +1,586 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "engine/attacks.h"
+#include "engine/movegen.h"
+#include "engine/game.h"
+#include "engine/search.h"
+#include "engine/tt.h"
+#include "engine/tablebase.h"
+#include "engine/instrument.h"
+
+// Serveur de parties sans interface : un protocole texte ligne à ligne, dans l'esprit
+// d'UCI, sur l'entrée et la sortie standard ou sur une socket Unix locale.
+// Usage : chess_server [--socket CHEMIN] [--threads N] [--hash MO] [--movetime MS] [--tables DOSSIER]
+//
+// Chaque ligne commence par une commande, suivie pour la plupart d'un identifiant de
+// session choisi par le client (propre à sa connexion) :
+//   new ID [time MS] [inc MS]                nouvelle partie, avec une pendule pour le moteur
+//   position ID startpos [moves M...]        position de départ, puis des coups
+//   position ID text PLATEAU TRAIT [moves M...]  position notée comme position_to_text
+//   move ID M...                             jouer des coups (notation "a1b2")
+//   go ID [depth N] [nodes N] [movetime MS]  chercher un coup, sans le jouer
+//   status ID                                partie en cours, 1-0, 0-1 ou 1/2
+//   quit ID                                  fermer la session
+//   stats                                    latences par commande et compteurs, jusqu'à "stats end"
+//   stats json                               mesures du moteur (instrument.h), en JSON sur une ligne
+//   shutdown                                 arrêter le serveur
+// Réponses : "ok ID", "bestmove ID M score S depth D nodes N time MS", "status ID R",
+// "bye ID", "error ID message".
+//
+// Les sessions sont réparties sur une réserve fixe de threads qui partagent la table de
+// transposition. Les requêtes d'une même session sont traitées dans l'ordre, une à la
+// fois ; des milliers de sessions peuvent attendre sans occuper de thread.
+
+#define DEFAULT_MOVETIME 100 // Budget d'un go sans limite ni pendule, en ms
+
+typedef std::chrono::steady_clock Clock;
+
+enum CommandKind { CMD_NEW, CMD_POSITION, CMD_MOVE, CMD_GO, CMD_STATUS, CMD_QUIT, CMD_COUNT };
+static const char* COMMAND_NAMES[CMD_COUNT] = {"new", "position", "move", "go", "status", "quit"};
+
+struct ServerStats {
+    Histogram latency[CMD_COUNT]; // Microsecondes
+    std::atomic<uint64_t> sessions{0}, peakSessions{0}, nodes{0};
+};
+static ServerStats stats;
+
+// Une connexion : stdin/stdout ou un client de la socket. Les réponses sont écrites
+// directement par le thread qui a traité la requête.
+struct Connection {
+    int inFd, outFd;
+    std::string input;             // Ligne en cours de lecture (thread d'entrée seulement)
+    std::mutex writeMutex;
+    std::atomic<bool> open{true};
+
+    Connection(int in, int out) : inFd(in), outFd(out) {}
+
+    // Fermé par le dernier propriétaire, jamais pendant qu'une réponse s'écrit
+    ~Connection() {
+        if (inFd > STDERR_FILENO) {
+            close(inFd);
+        }
+    }
+
+    void send(const std::string& line) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (!open.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::string data = line + "\n";
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t n = write(outFd, data.data() + written, data.size() - written);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                open.store(false, std::memory_order_relaxed); // Client parti
+                return;
+            }
+            written += static_cast<size_t>(n);
+        }
+    }
+};
+
+struct Request {
+    CommandKind kind;
+    std::vector<std::string> args; // Après l'identifiant de session
+    Clock::time_point received;
+    bool silent = false;           // Fermeture d'office : ni réponse ni mesure
+};
+
+struct Session {
+    std::string id;
+    std::shared_ptr<Connection> connection;
+    Game game;
+    int clock[2] = {0, 0};  // Temps restant du moteur pour chaque camp, 0 sans pendule
+    int increment = 0;
+    std::deque<Request> inbox; // Protégé par le mutex de l'ordonnanceur
+    bool scheduled = false;    // Dans la file des sessions prêtes ou en cours de traitement
+};
+
+// File des sessions qui ont du travail : une session n'y figure qu'une fois, et n'est
+// prise que par un thread à la fois, ce qui garde ses requêtes dans l'ordre
+class Scheduler {
+public:
+    void post(Session* session, Request request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            session->inbox.push_back(std::move(request));
+            if (session->scheduled) {
+                return;
+            }
+            session->scheduled = true;
+            ready.push_back(session);
+        }
+        wake.notify_one();
+    }
+
+    // Prochaine requête à traiter ; nullptr une fois le serveur arrêté et la file vide
+    Session* take(Request& request) {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this]() { return !ready.empty() || stopping; });
+        if (ready.empty()) {
+            return nullptr;
+        }
+        Session* session = ready.front();
+        ready.pop_front();
+        request = std::move(session->inbox.front());
+        session->inbox.pop_front();
+        return session;
+    }
+
+    // Requête traitée : remettre la session en file s'il lui reste du travail
+    void done(Session* session) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (session->inbox.empty()) {
+                session->scheduled = false;
+                return;
+            }
+            ready.push_back(session);
+        }
+        wake.notify_one();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Session*> ready;
+    bool stopping = false;
+};
+
+static int defaultMovetime = DEFAULT_MOVETIME;
+
+// Jouer des coups donnés en texte ; false au premier coup refusé
+static bool play_moves(Game* game, const std::vector<std::string>& args, size_t first) {
+    for (size_t i = first; i < args.size(); i++) {
+        MoveList moves;
+        generate_moves(game->pos, moves);
+        Move played = MOVE_NONE;
+        for (Move m : moves) {
+            if (move_to_text(m) == args[i]) {
+                played = m;
+                break;
+            }
+        }
+        if (played == MOVE_NONE) {
+            return false;
+        }
+        game->keys.push_back(game->pos.state.key);
+        apply_move(game->pos, played);
+        if (game->pos.state.pliesSinceCapture == 0) {
+            game->keys.clear(); // Aucune position d'avant la prise ne peut revenir
+        }
+    }
+    return true;
+}
+
+static const char* game_status(const Game& game) {
+    if (!hasRemainingPieces(&game.pos, PLAYER1)) {
+        return "0-1";
+    }
+    if (!hasRemainingPieces(&game.pos, PLAYER2)) {
+        return "1-0";
+    }
+    MoveList moves;
+    generate_moves(game.pos, moves);
+    if (moves.size == 0 || isThreefoldRepetition(&game)) {
+        return "1/2";
+    }
+    return "ongoing";
+}
+
+// Valeur qui suit un mot-clé dans les arguments, ou fallback
+static long long option_value(const std::vector<std::string>& args, const char* key, long long fallback) {
+    for (size_t i = 0; i + 1 < args.size(); i++) {
+        if (args[i] == key) {
+            return atoll(args[i + 1].c_str());
+        }
+    }
+    return fallback;
+}
+
+// Traiter une requête ; rend false si la session est terminée
+static bool handle(Session* session, const Request& request) {
+    Connection& out = *session->connection;
+    const std::vector<std::string>& args = request.args;
+    const std::string& id = session->id;
+    bool alive = true;
+
+    switch (request.kind) {
+        case CMD_NEW:
+            initialize_board(&session->game.pos);
+            session->game.keys.clear();
+            session->clock[PLAYER1] = session->clock[PLAYER2] = static_cast<int>(option_value(args, "time", 0));
+            session->increment = static_cast<int>(option_value(args, "inc", 0));
+            out.send("ok " + id);
+            break;
+        case CMD_POSITION: {
+            Game game;
+            size_t next = 1;
+            bool valid = false;
+            if (!args.empty() && args[0] == "startpos") {
+                initialize_board(&game.pos);
+                valid = true;
+            } else if (args.size() >= 3 && args[0] == "text") {
+                valid = position_from_text(&game.pos, (args[1] + " " + args[2]).c_str());
+                next = 3;
+            }
+            if (valid && next < args.size()) {
+                valid = args[next] == "moves" && play_moves(&game, args, next + 1);
+            }
+            if (!valid) {
+                out.send("error " + id + " position invalide");
+                break;
+            }
+            session->game = game;
+            out.send("ok " + id);
+            break;
+        }
+        case CMD_MOVE: {
+            // Les coups sont joués sur une copie : rien ne change si l'un d'eux est refusé
+            Game game = session->game;
+            if (!play_moves(&game, args, 0)) {
+                out.send("error " + id + " coup refusé");
+                break;
+            }
+            session->game = game;
+            out.send("ok " + id);
+            break;
+        }
+        case CMD_GO: {
+            Player us = session->game.pos.sideToMove;
+            SearchLimits limits;
+            limits.threads = 1; // Le parallélisme se fait entre les sessions
+            limits.depth = static_cast<int>(option_value(args, "depth", MAX_PLY - 1));
+            limits.nodes = static_cast<uint64_t>(option_value(args, "nodes", 0));
+            limits.movetime = static_cast<int>(option_value(args, "movetime", 0));
+            bool limited = limits.depth < MAX_PLY - 1 || limits.nodes != 0 || limits.movetime != 0;
+            if (!limited && session->clock[us] > 0) {
+                limits.time[us] = session->clock[us];
+                limits.increment[us] = session->increment;
+            } else if (!limited) {
+                limits.movetime = defaultMovetime;
+            }
+            limits.depth = std::max(1, std::min(limits.depth, MAX_PLY - 1));
+
+            Clock::time_point start = Clock::now();
+            SearchResult result = search(session->game.pos, limits, &session->game.keys);
+            int elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+            if (session->clock[us] > 0) {
+                // Pendule de la session : le temps pris est décompté, l'incrément ajouté
+                session->clock[us] = std::max(1, session->clock[us] - elapsed + session->increment);
+            }
+            stats.nodes.fetch_add(result.nodes, std::memory_order_relaxed);
+            std::ostringstream line;
+            line << "bestmove " << id << " "
+                 << (result.bestMove == MOVE_NONE ? std::string("none") : move_to_text(result.bestMove))
+                 << " score " << result.score << " depth " << result.depth << " nodes " << result.nodes
+                 << " time " << elapsed;
+            out.send(line.str());
+            break;
+        }
+        case CMD_STATUS:
+            out.send("status " + id + " " + game_status(session->game));
+            break;
+        case CMD_QUIT:
+            stats.sessions.fetch_sub(1, std::memory_order_relaxed);
+            if (request.silent) {
+                return false;
+            }
+            out.send("bye " + id);
+            alive = false;
+            break;
+        default:
+            break;
+    }
+    uint64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - request.received).count();
+    stats.latency[request.kind].record(micros);
+    return alive;
+}
+
+static void worker_loop(Scheduler& scheduler) {
+    Request request;
+    while (Session* session = scheduler.take(request)) {
+        if (!handle(session, request)) {
+            delete session; // Le thread d'entrée l'a déjà retirée de sa table
+            continue;
+        }
+        scheduler.done(session);
+    }
+}
+
+static std::string stats_report() {
+    std::ostringstream text;
+    text << "stats sessions " << stats.sessions.load() << " peak " << stats.peakSessions.load()
+         << " nodes " << stats.nodes.load();
+    for (int c = 0; c < CMD_COUNT; c++) {
+        const Histogram& h = stats.latency[c];
+        if (h.count() == 0) {
+            continue;
+        }
+        text << "\nlatency " << COMMAND_NAMES[c] << " count " << h.count() << " p50 " << h.percentile(50)
+             << " p90 " << h.percentile(90) << " p99 " << h.percentile(99) << " max " << h.max() << " us";
+    }
+    text << "\nstats end";
+    return text.str();
+}
+
+// Table des sessions, tenue par le seul thread d'entrée
+class Dispatcher {
+public:
+    explicit Dispatcher(Scheduler& s) : scheduler(s) {}
+
+    // Traiter une ligne ; rend false sur shutdown
+    bool line(const std::shared_ptr<Connection>& connection, const std::string& text) {
+        Clock::time_point received = Clock::now();
+        std::istringstream in(text);
+        std::string command, id;
+        in >> command;
+        if (command.empty()) {
+            return true;
+        }
+        if (command == "shutdown") {
+            return false;
+        }
+        if (command == "stats") {
+            std::string format;
+            connection->send(in >> format && format == "json" ? instrument_json() : stats_report());
+            return true;
+        }
+        int kind = 0;
+        while (kind < CMD_COUNT && command != COMMAND_NAMES[kind]) {
+            kind++;
+        }
+        if (kind == CMD_COUNT || !(in >> id)) {
+            connection->send("error - commande inconnue : " + text);
+            return true;
+        }
+        Request request;
+        request.kind = static_cast<CommandKind>(kind);
+        request.received = received;
+        for (std::string arg; in >> arg;) {
+            request.args.push_back(arg);
+        }
+
+        auto& sessions = connections[connection.get()];
+        auto it = sessions.find(id);
+        if (request.kind == CMD_NEW) {
+            if (it != sessions.end()) {
+                connection->send("error " + id + " session déjà ouverte");
+                return true;
+            }
+            Session* session = new Session();
+            session->id = id;
+            session->connection = connection;
+            it = sessions.emplace(id, session).first;
+            uint64_t open = stats.sessions.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (open > stats.peakSessions.load(std::memory_order_relaxed)) {
+                stats.peakSessions.store(open, std::memory_order_relaxed);
+            }
+        } else if (it == sessions.end()) {
+            connection->send("error " + id + " session inconnue");
+            return true;
+        }
+        Session* session = it->second;
+        if (request.kind == CMD_QUIT) {
+            sessions.erase(it); // Le thread qui traite quit libère la session
+        }
+        scheduler.post(session, std::move(request));
+        return true;
+    }
+
+    // Fermer les sessions d'une connexion, après les requêtes déjà reçues
+    void disconnect(Connection* connection) {
+        auto found = connections.find(connection);
+        if (found == connections.end()) {
+            return;
+        }
+        for (auto& entry : found->second) {
+            Request quit;
+            quit.kind = CMD_QUIT;
+            quit.received = Clock::now();
+            quit.silent = true;
+            scheduler.post(entry.second, std::move(quit));
+        }
+        connections.erase(found);
+    }
+
+    // Lire ce qui est disponible sur une connexion ; false à la fin du flux ou sur shutdown
+    bool read(const std::shared_ptr<Connection>& connection, bool& shutdown) {
+        char buffer[65536];
+        ssize_t n = ::read(connection->inFd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            return true;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        std::string& input = connection->input;
+        input.append(buffer, static_cast<size_t>(n));
+        size_t start = 0, end;
+        while ((end = input.find('\n', start)) != std::string::npos) {
+            std::string text = input.substr(start, end - start);
+            if (!text.empty() && text.back() == '\r') {
+                text.pop_back();
+            }
+            start = end + 1;
+            if (!line(connection, text)) {
+                shutdown = true;
+                break;
+            }
+        }
+        input.erase(0, start);
+        return !shutdown;
+    }
+
+private:
+    Scheduler& scheduler;
+    std::map<Connection*, std::map<std::string, Session*>> connections;
+};
+
+// Servir l'entrée et la sortie standard
+static void serve_stdio(Dispatcher& dispatcher) {
+    auto connection = std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO);
+    bool shutdown = false;
+    while (dispatcher.read(connection, shutdown)) {
+    }
+    // Fin de l'entrée ou shutdown : les requêtes déjà reçues reçoivent leur réponse
+    dispatcher.disconnect(connection.get());
+}
+
+// Servir une socket Unix : un seul thread attend sur toutes les connexions avec poll
+static bool serve_socket(Dispatcher& dispatcher, const std::string& path) {
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (listener < 0 || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0) {
+        close(listener);
+        return false;
+    }
+    std::cerr << "En écoute sur " << path << std::endl;
+
+    std::vector<std::shared_ptr<Connection>> clients;
+    bool shutdown = false;
+    while (!shutdown) {
+        std::vector<pollfd> fds(1 + clients.size());
+        fds[0] = {listener, POLLIN, 0};
+        for (size_t i = 0; i < clients.size(); i++) {
+            fds[i + 1] = {clients[i]->inFd, POLLIN, 0};
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (size_t i = clients.size(); i-- > 0 && !shutdown;) {
+            if (fds[i + 1].revents == 0) {
+                continue;
+            }
+            if (!dispatcher.read(clients[i], shutdown) && !shutdown) {
+                clients[i]->open.store(false, std::memory_order_relaxed); // Plus personne pour lire
+                dispatcher.disconnect(clients[i].get());
+                clients.erase(clients.begin() + i);
+            }
+        }
+        if (!shutdown && (fds[0].revents & POLLIN)) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                clients.push_back(std::make_shared<Connection>(fd, fd));
+            }
+        }
+    }
+    for (auto& client : clients) {
+        dispatcher.disconnect(client.get());
+    }
+    close(listener);
+    unlink(path.c_str());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    init_attacks();
+    init_zobrist();
+    signal(SIGPIPE, SIG_IGN); // Un client parti ne doit pas arrêter le serveur
+
+    std::string socketPath, tableDirectory = "tables";
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    size_t hashMegabytes = 64;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        if (option == "--socket") {
+            socketPath = argv[i + 1];
+        } else if (option == "--threads") {
+            threads = atoi(argv[i + 1]);
+        } else if (option == "--hash") {
+            hashMegabytes = strtoull(argv[i + 1], nullptr, 10);
+        } else if (option == "--movetime") {
+            defaultMovetime = atoi(argv[i + 1]);
+        } else if (option == "--tables") {
+            tableDirectory = argv[i + 1];
+        } else {
+            std::cerr << "Option inconnue : " << option << std::endl;
+            return 2;
+        }
+    }
+    threads = std::max(1, threads);
+    TT.resize(hashMegabytes);
+    tb_init(tableDirectory);
+
+    Scheduler scheduler;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back(worker_loop, std::ref(scheduler));
+    }
+
+    Dispatcher dispatcher(scheduler);
+    bool ok = true;
+    if (socketPath.empty()) {
+        serve_stdio(dispatcher);
+    } else {
+        ok = serve_socket(dispatcher, socketPath);
+        if (!ok) {
+            std::cerr << "Impossible d'écouter sur " << socketPath << std::endl;
+        }
+    }
+
+    scheduler.stop();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    std::cerr << stats_report() << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/stat.h>  // Pour mkdir
+#include "engine/attacks.h"
+#include "engine/movegen.h"
+#include "engine/tablebase.h"
+
+// Générateur des tables de finales par analyse rétrograde.
+// Usage : chess_tbgen [dossier] [pièces max] [threads]
+//
+// Les tables d'un même nombre de pièces sont construites par paires : (S au trait
+// contre T) et (T au trait contre S), car un coup tranquille fait passer de l'une à
+// l'autre. Une prise mène à une table plus petite, déjà écrite et relue par mmap.
+//
+// Chaque passe n résout les positions à distance n : un prédécesseur d'une perte
+// en n - 1 gagne en n, et une position dont tous les coups mènent à des gains
+// adverses perd en 1 + la plus longue de ces distances. Les prédécesseurs sont
+// obtenus en déjouant les coups (les déplacements sont symétriques), et chaque
+// passe est répartie entre les threads. Un indice couvrant toutes les images d'une
+// position par les symétries du plateau, un prédécesseur n'est déclaré perdu qu'après
+// lecture de la valeur de chacun de ses coups : un simple compteur de coups réfutés
+// compterait deux fois un coup vers une position symétrique. chess_bench tables
+// compare ensuite les tables écrites à un solveur indépendant.
+
+#define TB_DEFAULT_PIECES 3
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Nature d'une entrée, fixée à la première passe
+enum EntryKind : uint8_t {
+    ENTRY_CANNOT_LOSE, // Une prise gagne ou annule, ou aucun coup tranquille
+    ENTRY_CAN_LOSE,    // Perdue si tous ses coups tranquilles le sont
+    ENTRY_ALIAS,       // Image par la diagonale d'une position rangée ailleurs (tb_index)
+};
+
+// Table en cours de génération
+struct WorkTable {
+    int stm, other;   // Masques de types du joueur au trait et de l'adversaire
+    uint64_t size;
+    std::unique_ptr<std::atomic<int8_t>[]> values;    // 0 tant que la position n'est pas résolue
+    std::unique_ptr<uint8_t[]> kinds;                 // EntryKind
+    std::unique_ptr<std::atomic<int8_t>[]> scheduled; // Résolution fixée par une prise : +d gain, -d perte
+};
+
+// Une paire de tables liées par les coups tranquilles (une seule si S == T)
+struct Pair {
+    WorkTable tables[2];
+    int count;
+    std::atomic<int> maxScheduled{0}; // Plus grande distance différée
+    std::atomic<bool> missing{false}; // Une table plus petite manque
+    std::atomic<bool> overflow{false}; // Une distance ne tient pas sur un octet
+
+    int partner(int i) const { return count == 1 ? 0 : 1 - i; }
+};
+
+// Entrée d'une frontière : numéro de table dans la paire et indice
+static uint64_t encode(int table, uint64_t index) { return (static_cast<uint64_t>(table) << 40) | index; }
+static int entry_table(uint64_t entry) { return static_cast<int>(entry >> 40); }
+static uint64_t entry_index(uint64_t entry) { return entry & ((1ULL << 40) - 1); }
+
+// Découper [0, count) entre les threads ; fn(début, fin, numéro du thread)
+template <typename F>
+static void parallel_for(uint64_t count, int threads, F fn) {
+    std::vector<std::thread> pool;
+    uint64_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        uint64_t begin = t * chunk;
+        uint64_t end = std::min(count, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        pool.emplace_back(fn, begin, end, t);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+static void schedule(Pair& pair, WorkTable& table, uint64_t index, int distance) {
+    int d = std::abs(distance);
+    if (d > 127) {
+        pair.overflow = true;
+        return;
+    }
+    // Une perte peut être fixée par plusieurs threads, toujours à la même distance
+    table.scheduled[index].store(static_cast<int8_t>(distance), std::memory_order_relaxed);
+    int current = pair.maxScheduled.load();
+    while (d > current && !pair.maxScheduled.compare_exchange_weak(current, d)) {
+    }
+}
+
+// Valeurs des positions obtenues par une prise, lues dans les tables plus petites.
+// Retourne false si l'une d'elles manque.
+static bool capture_values(const Position& pos, int& bestWin, int& longestLoss, bool& draw) {
+    MoveList captures;
+    generate_moves(pos, captures, GEN_CAPTURES);
+    bestWin = 0;
+    longestLoss = 0;
+    draw = false;
+    for (Move m : captures) {
+        int v;
+        if (pos.counts[PLAYER2][EMPTY] == 1) {
+            v = 1; // Dernière pièce adverse prise
+        } else {
+            Position child = pos;
+            apply_move(child, m);
+            int childValue;
+            if (!tb_probe(child, childValue)) {
+                return false;
+            }
+            v = childValue < 0 ? 1 - childValue : childValue > 0 ? -1 - childValue : 0;
+        }
+        if (v > 0) {
+            bestWin = bestWin == 0 ? v : std::min(bestWin, v);
+        } else if (v < 0) {
+            longestLoss = std::max(longestLoss, -v);
+        } else {
+            draw = true;
+        }
+    }
+    return true;
+}
+
+// Première passe : images symétriques, valeurs imposées par les prises, positions pouvant perdre
+static void init_range(Pair& pair, int i, uint64_t begin, uint64_t end) {
+    WorkTable& table = pair.tables[i];
+    for (uint64_t index = begin; index < end; index++) {
+        table.values[index].store(0, std::memory_order_relaxed);
+        table.kinds[index] = ENTRY_CANNOT_LOSE;
+        table.scheduled[index].store(0, std::memory_order_relaxed);
+        Position pos;
+        tb_position(&pos, index, table.stm, table.other);
+        if (tb_index(pos, table.stm, table.other) != index) {
+            table.kinds[index] = ENTRY_ALIAS; // Valeur recopiée avant l'écriture
+            continue;
+        }
+        int bestWin, longestLoss;
+        bool draw;
+        if (!capture_values(pos, bestWin, longestLoss, draw)) {
+            pair.missing = true;
+            return;
+        }
+        MoveList quiets;
+        generate_moves(pos, quiets, GEN_QUIETS);
+        if (bestWin > 0) {
+            schedule(pair, table, index, bestWin);
+        } else if (!draw && quiets.size > 0) {
+            table.kinds[index] = ENTRY_CAN_LOSE;
+        } else if (!draw && longestLoss > 0) {
+            schedule(pair, table, index, -longestLoss); // Que des prises, toutes perdantes
+        }
+        // Sinon nulle : une prise annule, ou aucun coup possible
+    }
+}
+
+// Tous les coups tranquilles de pos mènent-ils à des gains adverses résolus avant la passe n ?
+static bool quiets_lost_before(const Position& pos, const WorkTable& children, int n) {
+    MoveList quiets;
+    generate_moves(pos, quiets, GEN_QUIETS);
+    for (Move m : quiets) {
+        Position child = pos;
+        apply_move(child, m);
+        int v = children.values[tb_index(child, children.stm, children.other)].load(std::memory_order_relaxed);
+        if (v <= 0 || v >= n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Déjouer les coups menant à une position résolue à la passe n - 1
+static void expand_range(Pair& pair, const std::vector<uint64_t>& frontier, uint64_t begin, uint64_t end,
+                         int n, std::vector<uint64_t>& next) {
+    for (uint64_t k = begin; k < end; k++) {
+        int i = entry_table(frontier[k]);
+        const WorkTable& table = pair.tables[i];
+        uint64_t index = entry_index(frontier[k]);
+        int value = table.values[index].load(std::memory_order_relaxed);
+        int j = pair.partner(i);
+        WorkTable& previous = pair.tables[j];
+
+        Position pos;
+        tb_position(&pos, index, table.stm, table.other);
+        Bitboard occupied = pos.occupied[PLAYER1] | pos.occupied[PLAYER2];
+        // Le joueur 2 vient de jouer : chacune de ses pièces a pu venir d'une case
+        // vide qu'elle attaque, puisque les déplacements sont symétriques
+        for (int type = QUEEN; type <= BISHOP; type++) {
+            if (pos.pieces[PLAYER2][type] == 0) {
+                continue;
+            }
+            int to = lsb(pos.pieces[PLAYER2][type]);
+            Bitboard origins = attacks_from(static_cast<PieceType>(type), to, occupied) & ~occupied;
+            while (origins) {
+                int from = pop_lsb(origins);
+                Position before = pos;
+                move_piece(&before, to, from);
+                before.sideToMove = PLAYER2;
+                uint64_t p = tb_index(before, previous.stm, previous.other);
+
+                int8_t unresolved = 0;
+                if (value < 0) {
+                    if (previous.values[p].compare_exchange_strong(unresolved, static_cast<int8_t>(n))) {
+                        next.push_back(encode(j, p));
+                    }
+                } else if (previous.kinds[p] == ENTRY_CAN_LOSE
+                           && previous.values[p].load(std::memory_order_relaxed) == 0) {
+                    Position mover;
+                    tb_position(&mover, p, previous.stm, previous.other);
+                    if (!quiets_lost_before(mover, table, n)) {
+                        continue;
+                    }
+                    // Tous les coups tranquilles réfutés : la perte dure aussi longtemps que la plus
+                    // longue prise (longestLoss compte déjà le demi-coup de la prise)
+                    int bestWin, longestLoss;
+                    bool draw;
+                    capture_values(mover, bestWin, longestLoss, draw);
+                    if (longestLoss <= n) {
+                        if (previous.values[p].compare_exchange_strong(unresolved, static_cast<int8_t>(-n))) {
+                            next.push_back(encode(j, p));
+                        }
+                    } else {
+                        schedule(pair, previous, p, -longestLoss);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Résoudre les positions dont la distance était fixée par une prise
+static void scheduled_range(Pair& pair, int i, uint64_t begin, uint64_t end, int n, std::vector<uint64_t>& next) {
+    WorkTable& table = pair.tables[i];
+    for (uint64_t index = begin; index < end; index++) {
+        int d = table.scheduled[index].load(std::memory_order_relaxed);
+        if (d != n && d != -n) {
+            continue;
+        }
+        int8_t unresolved = 0;
+        if (table.values[index].compare_exchange_strong(unresolved, static_cast<int8_t>(d))) {
+            next.push_back(encode(i, index));
+        }
+    }
+}
+
+// Écrire une table : en-tête de 32 octets puis une entrée par indice
+static bool write_table(const std::string& directory, const WorkTable& table, int maxDistance) {
+    std::string path = directory + "/" + tb_table_name(table.stm, table.other);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    uint8_t header[TB_HEADER_SIZE] = {'Q', 'N', 'R', 'B', 'T', 'B', '1', '\0'};
+    for (int b = 0; b < 4; b++) {
+        header[8 + b] = static_cast<uint8_t>(TB_VERSION >> (8 * b));
+    }
+    header[12] = static_cast<uint8_t>(table.stm);
+    header[13] = static_cast<uint8_t>(table.other);
+    header[14] = static_cast<uint8_t>(popcount(table.stm) + popcount(table.other));
+    header[15] = static_cast<uint8_t>(maxDistance);
+    for (int b = 0; b < 8; b++) {
+        header[16 + b] = static_cast<uint8_t>(table.size >> (8 * b));
+    }
+    file.write(reinterpret_cast<const char*>(header), TB_HEADER_SIZE);
+
+    std::vector<int8_t> buffer(std::min<uint64_t>(table.size, 1 << 20));
+    for (uint64_t start = 0; start < table.size; start += buffer.size()) {
+        uint64_t count = std::min<uint64_t>(buffer.size(), table.size - start);
+        for (uint64_t k = 0; k < count; k++) {
+            buffer[k] = table.values[start + k].load(std::memory_order_relaxed);
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), count);
+    }
+    return file.good();
+}
+
+// Construire et écrire la paire (S contre T, T contre S) ; false en cas d'erreur
+static bool generate_pair(const std::string& directory, int s, int t, int threads) {
+    auto start = Clock::now();
+    Pair pair;
+    pair.count = s == t ? 1 : 2;
+    int pieces = popcount(s) + popcount(t);
+    for (int i = 0; i < pair.count; i++) {
+        WorkTable& table = pair.tables[i];
+        table.stm = i == 0 ? s : t;
+        table.other = i == 0 ? t : s;
+        table.size = tb_table_size(pieces);
+        table.values.reset(new std::atomic<int8_t>[table.size]);
+        table.kinds.reset(new uint8_t[table.size]);
+        table.scheduled.reset(new std::atomic<int8_t>[table.size]);
+        parallel_for(table.size, threads, [&pair, i](uint64_t begin, uint64_t end, int) {
+            init_range(pair, i, begin, end);
+        });
+    }
+    if (pair.missing) {
+        std::cerr << "Table plus petite manquante pour " << tb_table_name(s, t) << std::endl;
+        return false;
+    }
+
+    std::vector<uint64_t> frontier;
+    int n = 1;
+    for (; n <= 127; n++) {
+        std::vector<std::vector<uint64_t>> next(threads);
+        parallel_for(frontier.size(), threads, [&](uint64_t begin, uint64_t end, int id) {
+            expand_range(pair, frontier, begin, end, n, next[id]);
+        });
+        if (n <= pair.maxScheduled) {
+            for (int i = 0; i < pair.count; i++) {
+                parallel_for(pair.tables[i].size, threads, [&, i](uint64_t begin, uint64_t end, int id) {
+                    scheduled_range(pair, i, begin, end, n, next[id]);
+                });
+            }
+        }
+        frontier.clear();
+        for (const auto& part : next) {
+            frontier.insert(frontier.end(), part.begin(), part.end());
+        }
+        if (frontier.empty() && n >= pair.maxScheduled) {
+            break;
+        }
+    }
+    if (n > 127 || pair.overflow) {
+        std::cerr << "Distance supérieure à 127 demi-coups dans " << tb_table_name(s, t) << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < pair.count; i++) {
+        WorkTable& table = pair.tables[i];
+        parallel_for(table.size, threads, [&table](uint64_t begin, uint64_t end, int) {
+            for (uint64_t index = begin; index < end; index++) {
+                if (table.kinds[index] == ENTRY_ALIAS) {
+                    Position pos;
+                    tb_position(&pos, index, table.stm, table.other);
+                    int8_t v = table.values[tb_index(pos, table.stm, table.other)].load(std::memory_order_relaxed);
+                    table.values[index].store(v, std::memory_order_relaxed);
+                }
+            }
+        });
+        uint64_t wins = 0, draws = 0, losses = 0;
+        int maxDistance = 0;
+        for (uint64_t index = 0; index < table.size; index++) {
+            if (table.kinds[index] == ENTRY_ALIAS) {
+                continue;
+            }
+            int v = table.values[index].load(std::memory_order_relaxed);
+            wins += v > 0;
+            draws += v == 0;
+            losses += v < 0;
+            maxDistance = std::max(maxDistance, std::abs(v));
+        }
+        if (!write_table(directory, table, maxDistance)) {
+            std::cerr << "Impossible d'écrire " << tb_table_name(table.stm, table.other) << std::endl;
+            return false;
+        }
+        std::cout << "  " << tb_table_name(table.stm, table.other) << " : " << wins << " gains, " << draws
+                  << " nulles, " << losses << " pertes, distance max " << maxDistance << std::endl;
+    }
+    double seconds = seconds_since(start);
+    uint64_t positions = pair.tables[0].size * pair.count;
+    std::cout << "    " << seconds << " s, " << static_cast<uint64_t>(seconds > 0 ? positions / seconds : 0)
+              << " positions/s" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    init_attacks();
+    init_zobrist();
+
+    std::string directory = argc > 1 ? argv[1] : "tables";
+    int maxPieces = argc > 2 ? atoi(argv[2]) : TB_DEFAULT_PIECES;
+    int threads = argc > 3 ? atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (maxPieces < 2 || maxPieces > TB_MAX_PIECES) {
+        std::cerr << "Usage : chess_tbgen [dossier] [pièces max, 2 à " << TB_MAX_PIECES << "] [threads]" << std::endl;
+        return 2;
+    }
+    threads = std::max(1, threads);
+    mkdir(directory.c_str(), 0755);
+
+    auto start = Clock::now();
+    for (int pieces = 2; pieces <= maxPieces; pieces++) {
+        tb_init(directory); // Les tables plus petites, pour les prises
+        for (int s = 1; s < 16; s++) {
+            for (int t = s; t < 16; t++) {
+                if (popcount(s) + popcount(t) != pieces) {
+                    continue;
+                }
+                if (tb_table_valid(directory + "/" + tb_table_name(s, t), s, t)
+                    && tb_table_valid(directory + "/" + tb_table_name(t, s), t, s)) {
+                    continue; // Déjà générée, au format courant
+                }
+                std::cout << tb_table_name(s, t) << std::endl;
+                if (!generate_pair(directory, s, t, threads)) {
+                    return 1;
+                }
+            }
+        }
+    }
+    tb_free();
+    std::cout << "Tables jusqu'à " << maxPieces << " pièces dans " << directory << " en "
+              << seconds_since(start) << " s (" << threads << " threads)" << std::endl;
+    return 0;
+}